@@ -19,6 +19,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include <libiscsi.h>
 #include <src/udisksdaemon.h>
 #include <src/udiskslogging.h>
@@ -403,6 +405,45 @@ udisks_linux_iscsi_session_object_process_uevent (UDisksModuleObject *module_obj
   return FALSE;
 }
 
+/* Claims the session directories in sysfs, i.e. all devices of this session */
+static gchar **
+udisks_linux_iscsi_session_object_get_claims (UDisksModuleObject *module_object)
+{
+  UDisksLinuxISCSISessionObject *session_object;
+  GHashTable *session_dirs;
+  GHashTableIter iter;
+  const gchar *sysfs_path;
+  gchar *needle;
+  GPtrArray *claims;
+
+  g_return_val_if_fail (UDISKS_IS_LINUX_ISCSI_SESSION_OBJECT (module_object), NULL);
+
+  session_object = UDISKS_LINUX_ISCSI_SESSION_OBJECT (module_object);
+  session_dirs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  needle = g_strdup_printf ("/%s/", session_object->session_id);
+
+  g_hash_table_iter_init (&iter, session_object->sysfs_paths);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &sysfs_path, NULL))
+    {
+      const gchar *match;
+
+      match = strstr (sysfs_path, needle);
+      if (match != NULL)
+        g_hash_table_add (session_dirs, g_strndup (sysfs_path, match - sysfs_path + strlen (needle) - 1));
+    }
+
+  claims = g_ptr_array_new ();
+  g_hash_table_iter_init (&iter, session_dirs);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &sysfs_path, NULL))
+    g_ptr_array_add (claims, udisks_module_object_claim_sysfs_path (sysfs_path));
+  g_ptr_array_add (claims, NULL);
+
+  g_hash_table_destroy (session_dirs);
+  g_free (needle);
+
+  return (gchar **) g_ptr_array_free (claims, FALSE);
+}
+
 static gboolean
 udisks_linux_iscsi_session_object_housekeeping (UDisksModuleObject  *object,
                                                 guint                secs_since_last,
@@ -420,4 +461,5 @@ void udisks_linux_iscsi_session_object_iface_init (UDisksModuleObjectIface *ifac
 {
   iface->process_uevent = udisks_linux_iscsi_session_object_process_uevent;
   iface->housekeeping = udisks_linux_iscsi_session_object_housekeeping;
+  iface->get_claims = udisks_linux_iscsi_session_object_get_claims;
 }
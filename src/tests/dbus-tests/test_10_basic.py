@@ -212,6 +212,66 @@ class UdisksBaseTest(udiskstestcase.UdisksTestCase):
             else:
                 self.fail('Failed to wipe device %s: %s' % (device, out))
 
+    def test_55_get_objects(self):
+        udisks = self.get_object('')
+        objects = udisks.GetManagedObjects(dbus_interface='org.freedesktop.DBus.ObjectManager')
+
+        # no filters, same as GetManagedObjects
+        manager = self.get_interface(self.manager_obj, '.Manager')
+        dbus_objects = manager.GetObjects(self.no_options)
+        self.assertEqual(set(dbus_objects.keys()), set(p for p in objects.keys() if objects[p]))
+
+        # only block devices with just the Block interface
+        options = dbus.Dictionary({'interfaces': dbus.Array([self.iface_prefix + '.Block'], signature='s'),
+                                   'object-path-prefixes': dbus.Array([self.path_prefix + '/block_devices/'], signature='s')},
+                                  signature='sv')
+        dbus_objects = manager.GetObjects(options)
+        block_paths = [p for p in objects.keys() if self.iface_prefix + '.Block' in objects[p]]
+        self.assertEqual(set(dbus_objects.keys()), set(block_paths))
+        for path, interfaces in dbus_objects.items():
+            self.assertEqual(list(interfaces.keys()), [self.iface_prefix + '.Block'])
+            self.assertEqual(interfaces[self.iface_prefix + '.Block']['Device'],
+                             objects[path][self.iface_prefix + '.Block']['Device'])
+
+        # prefix not matching anything
+        options = dbus.Dictionary({'object-path-prefixes': dbus.Array(['/i/dont/exist'], signature='s')},
+                                  signature='sv')
+        self.assertEqual(len(manager.GetObjects(options)), 0)
+
+    def test_56_query_block_devices(self):
+        manager = self.get_interface(self.manager_obj, '.Manager')
+        dbus_blocks = sorted(manager.GetBlockDevices(self.no_options))
+
+        # no options, all block devices sorted by object path
+        devices, total = manager.QueryBlockDevices(self.no_options)
+        self.assertEqual(total, len(dbus_blocks))
+        self.assertEqual(list(devices.keys()), dbus_blocks)
+
+        # selected properties only
+        options = dbus.Dictionary({'interfaces': dbus.Array([self.iface_prefix + '.Block'], signature='s'),
+                                   'properties': dbus.Array(['Device', 'Size'], signature='s')},
+                                  signature='sv')
+        devices, total = manager.QueryBlockDevices(options)
+        self.assertEqual(total, len(dbus_blocks))
+        for interfaces in devices.values():
+            self.assertEqual(list(interfaces.keys()), [self.iface_prefix + '.Block'])
+            self.assertEqual(sorted(interfaces[self.iface_prefix + '.Block'].keys()), ['Device', 'Size'])
+
+        # pagination
+        options = dbus.Dictionary({'offset': dbus.UInt32(1), 'limit': dbus.UInt32(2)}, signature='sv')
+        devices, total = manager.QueryBlockDevices(options)
+        self.assertEqual(total, len(dbus_blocks))
+        self.assertEqual(list(devices.keys()), dbus_blocks[1:3])
+
+        # our test disks have no filesystem and are not mounted
+        disk_path = '%s/block_devices/%s' % (self.path_prefix, os.path.basename(self.vdevs[0]))
+        options = dbus.Dictionary({'id-usage': 'filesystem'}, signature='sv')
+        devices, total = manager.QueryBlockDevices(options)
+        self.assertNotIn(disk_path, devices)
+        options = dbus.Dictionary({'mounted': False}, signature='sv')
+        devices, total = manager.QueryBlockDevices(options)
+        self.assertIn(disk_path, devices)
+
     def test_60_resolve_device(self):
         manager = self.get_interface(self.manager_obj, '.Manager')
 
@@ -261,6 +321,13 @@ class UdisksBaseTest(udiskstestcase.UdisksTestCase):
         self.assertEqual(len(devices), 1)
         self.assertIn(object_path, devices)
 
+        # and by its device number
+        spec = dbus.Dictionary({'devnum': dbus.UInt64(os.stat(self.vdevs[0]).st_rdev)}, signature='sv')
+        devices = manager.ResolveDevice(spec, self.no_options)
+
+        self.assertEqual(len(devices), 1)
+        self.assertIn(object_path, devices)
+
         # try to get the disk by specifying both path and label (it has no label
         # so this should return an empty list)
         spec = dbus.Dictionary({'path': self.vdevs[0], 'label': 'test'}, signature='sv')
@@ -318,6 +385,31 @@ class UdisksBaseTest(udiskstestcase.UdisksTestCase):
         self.assertEqual(len(devices), 1)
         self.assertIn(object_path, devices)
 
+    def test_61_resolve_devices(self):
+        manager = self.get_interface(self.manager_obj, '.Manager')
+        object_path0 = '%s/block_devices/%s' % (self.path_prefix, os.path.basename(self.vdevs[0]))
+        object_path1 = '%s/block_devices/%s' % (self.path_prefix, os.path.basename(self.vdevs[1]))
+
+        specs = dbus.Array([dbus.Dictionary({'path': self.vdevs[1]}, signature='sv'),
+                            dbus.Dictionary({}, signature='sv'),
+                            dbus.Dictionary({'path': '/dev/i-dont-exist'}, signature='sv'),
+                            dbus.Dictionary({'path': self.vdevs[0],
+                                             'devnum': dbus.UInt64(os.stat(self.vdevs[0]).st_rdev)}, signature='sv'),
+                            dbus.Dictionary({'path': self.vdevs[0], 'label': 'I-DONT-EXIST'}, signature='sv')],
+                           signature='a{sv}')
+        results = manager.ResolveDevices(specs, self.no_options)
+
+        # one result per devspec, in order, with errors reported per item
+        self.assertEqual(len(results), 5)
+        self.assertEqual(list(results[0][0]), [object_path1])
+        self.assertEqual(results[0][1], '')
+        self.assertEqual(len(results[1][0]), 0)
+        self.assertIn('Invalid device specification', results[1][1])
+        self.assertEqual(len(results[2][0]), 0)
+        self.assertEqual(results[2][1], '')
+        self.assertEqual(list(results[3][0]), [object_path0])
+        self.assertEqual(len(results[4][0]), 0)
+
     def test_80_device_presence(self):
         '''Test the debug devices are present on the bus'''
         for d in self.vdevs:
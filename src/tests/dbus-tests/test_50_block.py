@@ -350,6 +350,55 @@ class UdisksBlockTest(udiskstestcase.UdisksTestCase):
         self.assertIsNotNone(sec_conf)
         self.assertEqual(sec_conf[0][1]['passphrase-path'], self.str_to_ay(''))
 
+    def test_benchmark(self):
+
+        disk = self.get_object('/block_devices/' + os.path.basename(self.vdevs[0]))
+        self.assertIsNotNone(disk)
+
+        # random reads with several requests in flight
+        d = dbus.Dictionary(signature='sv')
+        d['pattern'] = 'rand-read'
+        d['queue-depth'] = dbus.UInt32(4)
+        d['runtime'] = dbus.UInt32(1)
+        results = disk.Benchmark(d, dbus_interface=self.iface_prefix + '.Block')
+        self.assertGreater(results['ios'], 0)
+        self.assertEqual(results['bytes'], results['ios'] * 4096)
+        self.assertGreater(results['iops'], 0)
+        self.assertLessEqual(results['latency-min'], results['latency-p50'])
+        self.assertLessEqual(results['latency-p50'], results['latency-p99'])
+        self.assertLessEqual(results['latency-p99'], results['latency-max'])
+
+        # sequential writes over the first 16 MiB
+        self.addCleanup(self.wipe_fs, self.vdevs[0])
+        d = dbus.Dictionary(signature='sv')
+        d['pattern'] = 'seq-write'
+        d['block-size'] = dbus.UInt64(64 * 1024)
+        d['region-size'] = dbus.UInt64(16 * 1024**2)
+        d['runtime'] = dbus.UInt32(1)
+        results = disk.Benchmark(d, dbus_interface=self.iface_prefix + '.Block')
+        self.assertGreater(results['throughput'], 0)
+
+        # invalid pattern, block size and queue depth
+        d = dbus.Dictionary(signature='sv')
+        d['pattern'] = 'backwards'
+        msg = 'Unknown benchmark pattern'
+        with self.assertRaisesRegex(dbus.exceptions.DBusException, msg):
+            disk.Benchmark(d, dbus_interface=self.iface_prefix + '.Block')
+
+        d = dbus.Dictionary(signature='sv')
+        d['block-size'] = dbus.UInt64(100)
+        d['runtime'] = dbus.UInt32(1)
+        msg = 'Block size must be a non-zero multiple of the logical sector size'
+        with self.assertRaisesRegex(dbus.exceptions.DBusException, msg):
+            disk.Benchmark(d, dbus_interface=self.iface_prefix + '.Block')
+
+        d = dbus.Dictionary(signature='sv')
+        d['queue-depth'] = dbus.UInt32(33)
+        d['runtime'] = dbus.UInt32(1)
+        msg = 'Queue depth must be between 1 and 32'
+        with self.assertRaisesRegex(dbus.exceptions.DBusException, msg):
+            disk.Benchmark(d, dbus_interface=self.iface_prefix + '.Block')
+
     def test_rescan(self):
 
         disk = self.get_object('/block_devices/' + os.path.basename(self.vdevs[0]))
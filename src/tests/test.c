@@ -23,6 +23,8 @@
 #include <stdlib.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <string.h>
 
@@ -30,6 +32,7 @@
 #include <udisksdaemon.h>
 #include <udisksspawnedjob.h>
 #include <udisksthreadedjob.h>
+#include <udiskslinuxdevice.h>
 
 #include "testutil.h"
 
@@ -236,6 +239,86 @@ test_spawned_job_read_stdout (void)
   g_free (s);
 }
 
+static void
+test_spawned_job_read_stdout_argv (void)
+{
+  UDisksSpawnedJob *job;
+  const gchar *argv[] = { UDISKS_TEST_DIR "/udisks-test-helper", "0", NULL };
+
+  job = udisks_spawned_job_new_argv (argv, NULL, getuid (), geteuid (), NULL, NULL);
+  g_assert_cmpstr (udisks_spawned_job_get_command_line (job), ==, "'" UDISKS_TEST_DIR "/udisks-test-helper' '0'");
+  udisks_spawned_job_start (job);
+  _g_assert_signal_received (job, "spawned-job-completed", G_CALLBACK (read_stdout_on_spawned_job_completed), NULL);
+  g_object_unref (job);
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+static void
+on_spawned_job_line (UDisksSpawnedJob *job,
+                     gboolean          standard_error,
+                     const gchar      *line,
+                     gpointer          user_data)
+{
+  GPtrArray *lines = user_data;
+
+  g_assert_false (standard_error);
+  g_ptr_array_add (lines, g_strdup (line));
+}
+
+static void
+test_spawned_job_line_func (void)
+{
+  UDisksSpawnedJob *job;
+  GPtrArray *lines;
+  gchar *s;
+
+  lines = g_ptr_array_new_with_free_func (g_free);
+  s = g_strdup_printf (UDISKS_TEST_DIR "/udisks-test-helper 0");
+  job = udisks_spawned_job_new (s, NULL, getuid (), geteuid (), NULL, NULL);
+  udisks_spawned_job_set_line_func (job, on_spawned_job_line, lines, NULL);
+  udisks_spawned_job_start (job);
+  _g_assert_signal_received (job, "spawned-job-completed", G_CALLBACK (read_stdout_on_spawned_job_completed), NULL);
+  g_assert_cmpuint (lines->len, ==, 2);
+  g_assert_cmpstr (lines->pdata[0], ==, "Hello Stdout");
+  g_assert_cmpstr (lines->pdata[1], ==, "Line 2");
+  g_object_unref (job);
+  g_ptr_array_unref (lines);
+  g_free (s);
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+static gboolean
+output_limit_on_spawned_job_completed (UDisksSpawnedJob *job,
+                                       GError           *error,
+                                       gint              status,
+                                       GString          *standard_output,
+                                       GString          *standard_error,
+                                       gpointer          user_data)
+{
+  g_assert_no_error (error);
+  g_assert_cmpstr (standard_output->str, ==, "Hello");
+  g_assert (WIFEXITED (status));
+  g_assert (WEXITSTATUS (status) == 0);
+  return FALSE;
+}
+
+static void
+test_spawned_job_output_limit (void)
+{
+  UDisksSpawnedJob *job;
+  gchar *s;
+
+  s = g_strdup_printf (UDISKS_TEST_DIR "/udisks-test-helper 0");
+  job = udisks_spawned_job_new (s, NULL, getuid (), geteuid (), NULL, NULL);
+  udisks_spawned_job_set_output_limit (job, 5);
+  udisks_spawned_job_start (job);
+  _g_assert_signal_received (job, "spawned-job-completed", G_CALLBACK (output_limit_on_spawned_job_completed), NULL);
+  g_object_unref (job);
+  g_free (s);
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 static gboolean
@@ -678,6 +761,65 @@ test_threaded_job_override_signal_handler (void)
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+static void
+rewrite_file (const gchar *path,
+              const gchar *contents)
+{
+  gint fd;
+
+  /* modify in place so that an already open descriptor sees the change */
+  fd = open (path, O_WRONLY | O_TRUNC);
+  g_assert_cmpint (fd, !=, -1);
+  g_assert_cmpint (write (fd, contents, strlen (contents)), ==, strlen (contents));
+  close (fd);
+}
+
+static void
+test_sysfs_attr_read (void)
+{
+  UDisksLinuxSysfsAttr *attr;
+  GError *error = NULL;
+  gchar *path;
+  gchar buf[16];
+  gchar small_buf[4];
+  gint fd;
+
+  fd = g_file_open_tmp ("udisks-test-sysfs-attr-XXXXXX", &path, &error);
+  g_assert_no_error (error);
+  close (fd);
+
+  rewrite_file (path, "    42        7\n");
+  attr = udisks_linux_sysfs_attr_new (path);
+  g_assert_cmpstr (udisks_linux_sysfs_attr_get_path (attr), ==, path);
+  g_assert (udisks_linux_sysfs_attr_read (attr, buf, sizeof (buf), &error));
+  g_assert_no_error (error);
+  g_assert_cmpstr (buf, ==, "    42        7");
+
+  /* every read starts from the beginning */
+  rewrite_file (path, "1\n");
+  g_assert (udisks_linux_sysfs_attr_read (attr, buf, sizeof (buf), &error));
+  g_assert_no_error (error);
+  g_assert_cmpstr (buf, ==, "1");
+
+  /* longer contents are truncated */
+  rewrite_file (path, "123456789\n");
+  g_assert (udisks_linux_sysfs_attr_read (attr, small_buf, sizeof (small_buf), &error));
+  g_assert_no_error (error);
+  g_assert_cmpstr (small_buf, ==, "123");
+  udisks_linux_sysfs_attr_free (attr);
+
+  unlink (path);
+  attr = udisks_linux_sysfs_attr_new (path);
+  g_assert (!udisks_linux_sysfs_attr_read (attr, buf, sizeof (buf), &error));
+  g_assert_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+  g_clear_error (&error);
+  udisks_linux_sysfs_attr_free (attr);
+
+  g_free (path);
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
 int
 main (int    argc,
       char **argv)
@@ -704,7 +846,10 @@ main (int    argc,
   g_test_add_func ("/udisks/daemon/spawned_job/override_signal_handler", test_spawned_job_override_signal_handler);
   g_test_add_func ("/udisks/daemon/spawned_job/premature_termination", test_spawned_job_premature_termination);
   g_test_add_func ("/udisks/daemon/spawned_job/read_stdout", test_spawned_job_read_stdout);
+  g_test_add_func ("/udisks/daemon/spawned_job/read_stdout_argv", test_spawned_job_read_stdout_argv);
   g_test_add_func ("/udisks/daemon/spawned_job/read_stderr", test_spawned_job_read_stderr);
+  g_test_add_func ("/udisks/daemon/spawned_job/line_func", test_spawned_job_line_func);
+  g_test_add_func ("/udisks/daemon/spawned_job/output_limit", test_spawned_job_output_limit);
   g_test_add_func ("/udisks/daemon/spawned_job/exit_status", test_spawned_job_exit_status);
   g_test_add_func ("/udisks/daemon/spawned_job/abnormal_termination", test_spawned_job_abnormal_termination);
   g_test_add_func ("/udisks/daemon/spawned_job/binary_output", test_spawned_job_binary_output);
@@ -719,6 +864,7 @@ main (int    argc,
   g_test_add_func ("/udisks/daemon/threaded_job_sync/failure", test_threaded_job_sync_failure);
   g_test_add_func ("/udisks/daemon/threaded_job_sync/cancelled_at_start", test_threaded_job_sync_cancelled_at_start);
   g_test_add_func ("/udisks/daemon/threaded_job_sync/cancelled_midway", test_threaded_job_sync_cancelled_midway);
+  g_test_add_func ("/udisks/daemon/sysfs_attr/read", test_sysfs_attr_read);
 
   ret = g_test_run();
 
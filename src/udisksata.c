@@ -338,9 +338,6 @@ udisks_ata_get_pm_state (const gchar *device, GError **error, guchar *pm_state)
 {
   int fd;
   gboolean rc = FALSE;
-  /* ATA8: 7.8 CHECK POWER MODE - E5h, Non-Data */
-  UDisksAtaCommandInput input = {.command = 0xe5};
-  UDisksAtaCommandOutput output = {0};
 
   g_warn_if_fail (device != NULL);
 
@@ -353,6 +350,32 @@ udisks_ata_get_pm_state (const gchar *device, GError **error, guchar *pm_state)
       goto out;
     }
 
+  rc = udisks_ata_get_pm_state_fd (fd, error, pm_state);
+
+ out:
+  if (fd != -1)
+    close (fd);
+  return rc;
+}
+
+/**
+ * udisks_ata_get_pm_state_fd:
+ * @fd: A file descriptor of an open ATA drive block device.
+ * @error: Return location for error.
+ * @pm_state: Return location for the current power state value.
+ *
+ * Like udisks_ata_get_pm_state() but sends the command to an already
+ * open device, see udisks_ata_get_pm_state() for the meaning of @pm_state.
+ *
+ * Returns: %TRUE if the operation succeeded, %FALSE if @error is set.
+ */
+gboolean
+udisks_ata_get_pm_state_fd (gint fd, GError **error, guchar *pm_state)
+{
+  /* ATA8: 7.8 CHECK POWER MODE - E5h, Non-Data */
+  UDisksAtaCommandInput input = {.command = 0xe5};
+  UDisksAtaCommandOutput output = {0};
+
   if (!udisks_ata_send_command_sync (fd,
                                      -1,
                                      UDISKS_ATA_COMMAND_PROTOCOL_NONE,
@@ -361,13 +384,9 @@ udisks_ata_get_pm_state (const gchar *device, GError **error, guchar *pm_state)
                                      error))
     {
       g_prefix_error (error, "Error sending ATA command CHECK POWER MODE: ");
-      goto out;
+      return FALSE;
     }
   /* pm_state field is used for the state, see ATA8: table 102 */
   *pm_state = output.count;
-  rc = TRUE;
- out:
-  if (fd != -1)
-    close (fd);
-  return rc;
+  return TRUE;
 }
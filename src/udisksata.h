@@ -93,6 +93,9 @@ gboolean udisks_ata_send_command_sync (gint                       fd,
 gboolean udisks_ata_get_pm_state      (const gchar               *device,
                                        GError                   **error,
                                        guchar                    *pm_state);
+gboolean udisks_ata_get_pm_state_fd   (gint                       fd,
+                                       GError                   **error,
+                                       guchar                    *pm_state);
 
 G_END_DECLS
 
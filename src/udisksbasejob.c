@@ -27,9 +27,14 @@
 #include "udisksbasejob.h"
 #include "udisksdaemon.h"
 #include "udisksdaemonutil.h"
+#include "udisksconfigmanager.h"
 #include "udisks-daemon-marshal.h"
 
-#define MAX_SAMPLES 100
+/* number of progress samples the rate is measured over */
+#define RATE_WINDOW 16
+
+/* number of samples needed before making an estimate */
+#define RATE_MIN_SAMPLES 5
 
 typedef struct
 {
@@ -53,8 +58,25 @@ struct _UDisksBaseJobPrivate
   gboolean auto_estimate;
   gulong notify_progress_signal_handler_id;
 
-  Sample *samples;
+  /* ring buffer of the last RATE_WINDOW progress samples */
+  Sample samples[RATE_WINDOW];
+  guint samples_head;
   guint num_samples;
+
+  /* exponentially weighted moving average of the progress per usec */
+  gdouble rate_smoothing;
+  gdouble avg_speed;
+
+  /* rate limiting of the estimate properties */
+  gint64 estimate_interval_usec;
+  gint64 estimate_last_update;
+
+  /* rate limiting of progress updates, see udisks_base_job_set_progress() */
+  GMutex progress_lock;
+  gint64 progress_interval_usec;
+  gint64 progress_last_update;
+  gdouble progress_pending;
+  GSource *progress_source;
 };
 
 static void job_iface_init (UDisksJobIface *iface);
@@ -76,8 +98,7 @@ udisks_base_job_finalize (GObject *object)
 {
   UDisksBaseJob *job = UDISKS_BASE_JOB (object);
 
-
-  g_free (job->priv->samples);
+  g_mutex_clear (&job->priv->progress_lock);
 
   if (job->priv->cancellable != NULL)
     {
@@ -158,6 +179,14 @@ udisks_base_job_constructed (GObject *object)
   if (job->priv->cancellable == NULL)
     job->priv->cancellable = g_cancellable_new ();
 
+  if (job->priv->daemon != NULL)
+    {
+      UDisksConfigManager *config_manager = udisks_daemon_get_config_manager (job->priv->daemon);
+      job->priv->progress_interval_usec =
+        (gint64) udisks_config_manager_get_progress_update_interval (config_manager) * 1000;
+      job->priv->estimate_interval_usec = job->priv->progress_interval_usec;
+    }
+
   if (G_OBJECT_CLASS (udisks_base_job_parent_class)->constructed != NULL)
     G_OBJECT_CLASS (udisks_base_job_parent_class)->constructed (object);
 }
@@ -170,6 +199,10 @@ udisks_base_job_init (UDisksBaseJob *job)
   gint64 now_usec;
 
   job->priv = udisks_base_job_get_instance_private (job);
+  g_mutex_init (&job->priv->progress_lock);
+  job->priv->progress_interval_usec = UDISKS_PROGRESS_UPDATE_INTERVAL_DEFAULT * 1000;
+  job->priv->estimate_interval_usec = job->priv->progress_interval_usec;
+  job->priv->rate_smoothing = UDISKS_BASE_JOB_RATE_SMOOTHING_DEFAULT;
 
   now_usec = g_get_real_time ();
   udisks_job_set_start_time (UDISKS_JOB (job), now_usec);
@@ -460,11 +493,10 @@ on_notify_progress (GObject     *object,
                     gpointer     user_data)
 {
   UDisksBaseJob *job = UDISKS_BASE_JOB (user_data);
+  UDisksBaseJobPrivate *priv = job->priv;
   Sample *sample;
-  guint n;
-  gdouble sum_of_speeds;
-  guint num_speeds;
-  gdouble avg_speed;
+  Sample *oldest;
+  gdouble speed;
   gint64 usec_remaining;
   gint64 now;
   guint64 bytes;
@@ -473,46 +505,52 @@ on_notify_progress (GObject     *object,
   now = g_get_real_time ();
   current_progress = udisks_job_get_progress (UDISKS_JOB (job));
 
-  /* first add new sample... */
-  if (job->priv->num_samples == MAX_SAMPLES)
-    {
-      memmove (job->priv->samples, job->priv->samples + 1, sizeof (Sample) * (MAX_SAMPLES - 1));
-      job->priv->num_samples -= 1;
-    }
-  sample = &job->priv->samples[job->priv->num_samples++];
+  /* first add new sample, replacing the oldest one once the ring is full... */
+  sample = &priv->samples[priv->samples_head];
   sample->time_usec = now;
   sample->value = current_progress;
+  priv->samples_head = (priv->samples_head + 1) % RATE_WINDOW;
+  if (priv->num_samples < RATE_WINDOW)
+    priv->num_samples++;
 
   /* ... then update expected-end-time from samples - we want at
-   * least five samples before making an estimate...
+   * least a few samples before making an estimate...
    */
-  if (job->priv->num_samples < 5)
+  if (priv->num_samples < RATE_MIN_SAMPLES)
     goto out;
 
-  num_speeds = 0;
-  sum_of_speeds = 0.0;
-  for (n = 1; n < job->priv->num_samples; n++)
-    {
-      Sample *a = &job->priv->samples[n-1];
-      Sample *b = &job->priv->samples[n];
-      gdouble speed;
-      speed = (b->value - a->value) / (b->time_usec - a->time_usec);
-      sum_of_speeds += speed;
-      num_speeds++;
-    }
-  avg_speed = sum_of_speeds / num_speeds;
+  /* ... using the speed over the whole window, which is less sensitive to
+   * bursts than the speed between two successive samples, smoothed over
+   * successive windows
+   */
+  oldest = &priv->samples[(priv->samples_head + RATE_WINDOW - priv->num_samples) % RATE_WINDOW];
+  if (sample->time_usec <= oldest->time_usec)
+    goto out;
+  speed = (sample->value - oldest->value) / (sample->time_usec - oldest->time_usec);
+  if (priv->avg_speed <= 0.0)
+    priv->avg_speed = speed;
+  else
+    priv->avg_speed = priv->rate_smoothing * speed + (1.0 - priv->rate_smoothing) * priv->avg_speed;
+
+  if (priv->avg_speed <= 0.0)
+    goto out;
+
+  /* don't flood the bus with estimates, they change on every sample */
+  if (current_progress < 1.0 && now - priv->estimate_last_update < priv->estimate_interval_usec)
+    goto out;
+  priv->estimate_last_update = now;
 
   bytes = udisks_job_get_bytes (UDISKS_JOB (job));
   if (bytes > 0)
     {
-      udisks_job_set_rate (UDISKS_JOB (job), bytes * avg_speed * G_USEC_PER_SEC);
+      udisks_job_set_rate (UDISKS_JOB (job), bytes * priv->avg_speed * G_USEC_PER_SEC);
     }
   else
     {
       udisks_job_set_rate (UDISKS_JOB (job), 0);
     }
 
-  usec_remaining = (1.0 - current_progress) / avg_speed;
+  usec_remaining = (1.0 - current_progress) / priv->avg_speed;
   udisks_job_set_expected_end_time (UDISKS_JOB (job), now + usec_remaining);
 
  out:
@@ -537,8 +575,9 @@ udisks_base_job_set_auto_estimate (UDisksBaseJob  *job,
 
   if (value)
     {
-      if (job->priv->samples == NULL)
-        job->priv->samples = g_new0 (Sample, MAX_SAMPLES);
+      job->priv->samples_head = 0;
+      job->priv->num_samples = 0;
+      job->priv->avg_speed = 0.0;
       g_assert_cmpint (job->priv->notify_progress_signal_handler_id, ==, 0);
       job->priv->notify_progress_signal_handler_id = g_signal_connect (job,
                                                                        "notify::progress",
@@ -559,3 +598,114 @@ udisks_base_job_set_auto_estimate (UDisksBaseJob  *job,
  out:
   ;
 }
+
+/**
+ * udisks_base_job_set_rate_smoothing:
+ * @job: A #UDisksBaseJob.
+ * @smoothing: Weight of the newest rate measurement, between 0.0 (exclusive) and 1.0.
+ *
+ * Sets how strongly the rate used for auto-estimation is smoothed. The
+ * rate measured over the last few progress updates is combined with the
+ * previous estimate as an exponentially weighted moving average, with
+ * @smoothing being the weight of the new measurement. Lower values make
+ * the estimate more stable for jobs with bursty progress, 1.0 disables
+ * the smoothing. The default is %UDISKS_BASE_JOB_RATE_SMOOTHING_DEFAULT.
+ *
+ * Since: 2.11.0
+ */
+void
+udisks_base_job_set_rate_smoothing (UDisksBaseJob  *job,
+                                    gdouble         smoothing)
+{
+  g_return_if_fail (UDISKS_IS_BASE_JOB (job));
+  g_return_if_fail (smoothing > 0.0 && smoothing <= 1.0);
+  job->priv->rate_smoothing = smoothing;
+}
+
+/**
+ * udisks_base_job_set_estimate_update_interval:
+ * @job: A #UDisksBaseJob.
+ * @interval_msec: Minimum interval in milliseconds or 0 to update on every progress change.
+ *
+ * Sets the minimum interval between auto-estimated updates of the
+ * #UDisksJob:rate and #UDisksJob:expected-end-time properties. The
+ * default is the <literal>progress_update_interval</literal> set in the
+ * udisks2.conf file.
+ *
+ * Since: 2.11.0
+ */
+void
+udisks_base_job_set_estimate_update_interval (UDisksBaseJob  *job,
+                                              guint           interval_msec)
+{
+  g_return_if_fail (UDISKS_IS_BASE_JOB (job));
+  job->priv->estimate_interval_usec = (gint64) interval_msec * 1000;
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+static gboolean
+on_progress_timeout (gpointer user_data)
+{
+  UDisksBaseJob *job = UDISKS_BASE_JOB (user_data);
+
+  g_mutex_lock (&job->priv->progress_lock);
+  g_clear_pointer (&job->priv->progress_source, g_source_unref);
+  job->priv->progress_last_update = g_get_monotonic_time ();
+  udisks_job_set_progress (UDISKS_JOB (job), job->priv->progress_pending);
+  g_mutex_unlock (&job->priv->progress_lock);
+
+  return G_SOURCE_REMOVE;
+}
+
+/**
+ * udisks_base_job_set_progress:
+ * @job: A #UDisksBaseJob.
+ * @progress: The progress of the job, between 0.0 and 1.0.
+ *
+ * Like udisks_job_set_progress() but rate limited to the interval
+ * configured by the <literal>progress_update_interval</literal> key in
+ * the udisks2.conf file. Intermediate values arriving faster than that
+ * are coalesced and the last one is published once the interval
+ * elapses. The initial (0.0) and final (1.0) values are always
+ * published immediately.
+ *
+ * This is useful for jobs reporting progress very frequently, such as
+ * after every block written. It is safe to call this from any thread.
+ */
+void
+udisks_base_job_set_progress (UDisksBaseJob  *job,
+                              gdouble         progress)
+{
+  gint64 now;
+  gint64 elapsed;
+
+  g_return_if_fail (UDISKS_IS_BASE_JOB (job));
+
+  now = g_get_monotonic_time ();
+
+  g_mutex_lock (&job->priv->progress_lock);
+  job->priv->progress_pending = progress;
+  elapsed = now - job->priv->progress_last_update;
+  if (progress <= 0.0 || progress >= 1.0 || elapsed >= job->priv->progress_interval_usec)
+    {
+      if (job->priv->progress_source != NULL)
+        {
+          g_source_destroy (job->priv->progress_source);
+          g_clear_pointer (&job->priv->progress_source, g_source_unref);
+        }
+      job->priv->progress_last_update = now;
+      udisks_job_set_progress (UDISKS_JOB (job), progress);
+    }
+  else if (job->priv->progress_source == NULL)
+    {
+      /* make sure the last value is published even if no more updates come */
+      job->priv->progress_source = g_timeout_source_new ((job->priv->progress_interval_usec - elapsed) / 1000 + 1);
+      g_source_set_callback (job->priv->progress_source,
+                             on_progress_timeout,
+                             g_object_ref (job),
+                             g_object_unref);
+      g_source_attach (job->priv->progress_source, NULL);
+    }
+  g_mutex_unlock (&job->priv->progress_lock);
+}
@@ -61,12 +61,26 @@ struct _UDisksBaseJobClass
   gpointer padding[8];
 };
 
+/**
+ * UDISKS_BASE_JOB_RATE_SMOOTHING_DEFAULT:
+ *
+ * Default weight of the newest rate measurement used for auto-estimation,
+ * see udisks_base_job_set_rate_smoothing().
+ */
+#define UDISKS_BASE_JOB_RATE_SMOOTHING_DEFAULT 0.3
+
 GType              udisks_base_job_get_type          (void) G_GNUC_CONST;
 UDisksDaemon      *udisks_base_job_get_daemon        (UDisksBaseJob  *job);
 GCancellable      *udisks_base_job_get_cancellable   (UDisksBaseJob  *job);
 gboolean           udisks_base_job_get_auto_estimate (UDisksBaseJob  *job);
 void               udisks_base_job_set_auto_estimate (UDisksBaseJob  *job,
                                                       gboolean        value);
+void               udisks_base_job_set_progress      (UDisksBaseJob  *job,
+                                                      gdouble         progress);
+void               udisks_base_job_set_rate_smoothing (UDisksBaseJob  *job,
+                                                       gdouble         smoothing);
+void               udisks_base_job_set_estimate_update_interval (UDisksBaseJob  *job,
+                                                                 guint           interval_msec);
 
 void               udisks_base_job_add_object        (UDisksBaseJob  *job,
                                                       UDisksObject   *object);
@@ -36,6 +36,7 @@ struct _UDisksConfigManager {
   UDisksModuleLoadPreference load_preference;
 
   const gchar *encryption;
+  guint progress_update_interval;
   gchar *config_dir;
 };
 
@@ -57,6 +58,7 @@ enum
 #define MODULES_GROUP_NAME  PACKAGE_NAME_UDISKS2
 #define MODULES_KEY "modules"
 #define MODULES_LOAD_PREFERENCE_KEY "modules_load_preference"
+#define PROGRESS_UPDATE_INTERVAL_KEY "progress_update_interval"
 
 #define DEFAULTS_GROUP_NAME "defaults"
 #define DEFAULTS_ENCRYPTION_KEY "encryption"
@@ -142,12 +144,14 @@ static void
 parse_config_file (UDisksConfigManager         *manager,
                    UDisksModuleLoadPreference  *out_load_preference,
                    const gchar                **out_encryption,
+                   guint                       *out_progress_update_interval,
                    GList                      **out_modules)
 {
   GKeyFile *config_file;
   gchar *conf_filename;
   gchar *load_preference;
   gchar *encryption;
+  gint interval;
   gchar *module_i;
   gchar **modules;
   gchar **modules_tmp;
@@ -223,6 +227,23 @@ parse_config_file (UDisksConfigManager         *manager,
               g_free (encryption);
             }
         }
+
+      if (out_progress_update_interval != NULL &&
+          g_key_file_has_key (config_file, MODULES_GROUP_NAME, PROGRESS_UPDATE_INTERVAL_KEY, NULL))
+        {
+          /* Read the minimum interval between progress property updates. */
+          interval = g_key_file_get_integer (config_file, MODULES_GROUP_NAME, PROGRESS_UPDATE_INTERVAL_KEY, &l_error);
+          if (l_error != NULL || interval < 0)
+            {
+              udisks_warning ("Invalid value used for '%s'; defaulting to %u",
+                              PROGRESS_UPDATE_INTERVAL_KEY, UDISKS_PROGRESS_UPDATE_INTERVAL_DEFAULT);
+              g_clear_error (&l_error);
+            }
+          else
+            {
+              *out_progress_update_interval = interval;
+            }
+        }
     }
   else
     {
@@ -260,7 +281,11 @@ udisks_config_manager_constructed (GObject *object)
       udisks_warning ("Error creating directory %s: %m", manager->config_dir);
     }
 
-  parse_config_file (manager, &manager->load_preference, &manager->encryption, NULL);
+  parse_config_file (manager,
+                     &manager->load_preference,
+                     &manager->encryption,
+                     &manager->progress_update_interval,
+                     NULL);
 
   if (G_OBJECT_CLASS (udisks_config_manager_parent_class))
     G_OBJECT_CLASS (udisks_config_manager_parent_class)->constructed (object);
@@ -352,6 +377,7 @@ udisks_config_manager_init (UDisksConfigManager *manager)
 {
   manager->load_preference = UDISKS_MODULE_LOAD_ONDEMAND;
   manager->encryption = UDISKS_ENCRYPTION_DEFAULT;
+  manager->progress_update_interval = UDISKS_PROGRESS_UPDATE_INTERVAL_DEFAULT;
 }
 
 UDisksConfigManager *
@@ -396,7 +422,7 @@ udisks_config_manager_get_modules (UDisksConfigManager *manager)
 
   g_return_val_if_fail (UDISKS_IS_CONFIG_MANAGER (manager), NULL);
 
-  parse_config_file (manager, NULL, NULL, &modules);
+  parse_config_file (manager, NULL, NULL, NULL, &modules);
   return modules;
 }
 
@@ -417,7 +443,7 @@ udisks_config_manager_get_modules_all (UDisksConfigManager *manager)
 
   g_return_val_if_fail (UDISKS_IS_CONFIG_MANAGER (manager), FALSE);
 
-  parse_config_file (manager, NULL, NULL, &modules);
+  parse_config_file (manager, NULL, NULL, NULL, &modules);
 
   ret = !modules || (g_strcmp0 (modules->data, MODULES_ALL_ARG) == 0 && g_list_length (modules) == 1);
 
@@ -442,6 +468,25 @@ udisks_config_manager_get_encryption (UDisksConfigManager *manager)
   return manager->encryption;
 }
 
+/**
+ * udisks_config_manager_get_progress_update_interval:
+ * @manager: A #UDisksConfigManager.
+ *
+ * Gets the minimum interval between updates of frequently changing
+ * progress properties, such as job progress or MD RAID sync status,
+ * as set by the <literal>progress_update_interval</literal> key in
+ * the udisks2.conf file.
+ *
+ * Returns: The interval in milliseconds.
+ */
+guint
+udisks_config_manager_get_progress_update_interval (UDisksConfigManager *manager)
+{
+  g_return_val_if_fail (UDISKS_IS_CONFIG_MANAGER (manager),
+                        UDISKS_PROGRESS_UPDATE_INTERVAL_DEFAULT);
+  return manager->progress_update_interval;
+}
+
 /**
  * udisks_config_manager_get_config_dir:
  * @manager: A #UDisksConfigManager.
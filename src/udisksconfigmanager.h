@@ -49,6 +49,8 @@ typedef enum
 #define UDISKS_ENCRYPTION_LUKS2 "luks2"
 #define UDISKS_ENCRYPTION_DEFAULT UDISKS_ENCRYPTION_LUKS1
 
+#define UDISKS_PROGRESS_UPDATE_INTERVAL_DEFAULT 1000
+
 GType                 udisks_config_manager_get_type        (void) G_GNUC_CONST;
 UDisksConfigManager  *udisks_config_manager_new             (void);
 UDisksConfigManager  *udisks_config_manager_new_uninstalled (void);
@@ -60,6 +62,7 @@ gboolean              udisks_config_manager_get_modules_all (UDisksConfigManager
 UDisksModuleLoadPreference
                       udisks_config_manager_get_load_preference (UDisksConfigManager *manager);
 const gchar          *udisks_config_manager_get_encryption (UDisksConfigManager *manager);
+guint                 udisks_config_manager_get_progress_update_interval (UDisksConfigManager *manager);
 const gchar * const  *udisks_config_manager_get_supported_encryption_types (UDisksConfigManager *manager);
 
 const gchar          *udisks_config_manager_get_config_dir  (UDisksConfigManager *manager);
@@ -1078,6 +1078,49 @@ udisks_daemon_launch_spawned_job_gstring (
   return common_job (daemon, object, job_operation, job_started_by_uid, job);
 }
 
+/**
+ * udisks_daemon_launch_spawned_job_argv:
+ * @daemon: A #UDisksDaemon.
+ * @object: (allow-none): A #UDisksObject to add to the job or %NULL.
+ * @job_operation: The operation for the job.
+ * @job_started_by_uid: The user who started the job.
+ * @cancellable: A #GCancellable or %NULL.
+ * @run_as_uid: The #uid_t to run the command as.
+ * @run_as_euid: The effective #uid_t to run the command as.
+ * @input_string: A string to write to stdin of the spawned program or %NULL.
+ * @argv: (array zero-terminated=1): The program and its arguments to spawn.
+ *
+ * Like udisks_daemon_launch_spawned_job_gstring() but takes an already
+ * split argument vector instead of a command line that needs quoting
+ * and parsing.
+ *
+ * Returns: A #UDisksSpawnedJob object. Do not free, the object
+ * belongs to @manager.
+ *
+ * Since: 2.11.0
+ */
+UDisksBaseJob *
+udisks_daemon_launch_spawned_job_argv (UDisksDaemon        *daemon,
+                                       UDisksObject        *object,
+                                       const gchar         *job_operation,
+                                       uid_t                job_started_by_uid,
+                                       GCancellable        *cancellable,
+                                       uid_t                run_as_uid,
+                                       uid_t                run_as_euid,
+                                       GString             *input_string,
+                                       const gchar * const *argv)
+{
+  UDisksSpawnedJob *job;
+
+  g_return_val_if_fail (UDISKS_IS_DAEMON (daemon), NULL);
+  g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
+  g_return_val_if_fail (argv != NULL && argv[0] != NULL, NULL);
+
+  job = udisks_spawned_job_new_argv (argv, input_string, run_as_uid, run_as_euid, daemon, cancellable);
+
+  return common_job (daemon, object, job_operation, job_started_by_uid, job);
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 typedef struct
@@ -1114,6 +1157,45 @@ spawned_job_sync_on_completed (UDisksJob    *job,
   g_main_loop_quit (data->loop);
 }
 
+/* runs @job in a private main context, must be called with the context pushed */
+static gboolean
+spawned_job_run_sync (UDisksBaseJob      *job,
+                      SpawnedJobSyncData *data,
+                      gint               *out_status,
+                      gchar             **out_message)
+{
+  data->loop = g_main_loop_new (data->context, FALSE);
+  data->success = FALSE;
+  data->status = 0;
+  data->message = NULL;
+
+  g_signal_connect (job,
+                    "spawned-job-completed",
+                    G_CALLBACK (spawned_job_sync_on_spawned_job_completed),
+                    data);
+  g_signal_connect_after (job,
+                          "completed",
+                          G_CALLBACK (spawned_job_sync_on_completed),
+                          data);
+
+  udisks_spawned_job_start (UDISKS_SPAWNED_JOB (job));
+  g_main_loop_run (data->loop);
+
+  if (out_status != NULL)
+    *out_status = data->status;
+
+  if (out_message != NULL)
+    *out_message = data->message;
+  else
+    g_free (data->message);
+
+  g_main_loop_unref (data->loop);
+
+  /* note: the job object is freed in the ::completed handler */
+
+  return data->success;
+}
+
 /**
  * udisks_daemon_launch_spawned_job_sync:
  * @daemon: A #UDisksDaemon.
@@ -1220,6 +1302,7 @@ udisks_daemon_launch_spawned_job_gstring_sync (UDisksDaemon    *daemon,
   gchar *command_line;
   UDisksBaseJob *job;
   SpawnedJobSyncData data;
+  gboolean ret;
 
   g_return_val_if_fail (UDISKS_IS_DAEMON (daemon), FALSE);
   g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), FALSE);
@@ -1227,10 +1310,6 @@ udisks_daemon_launch_spawned_job_gstring_sync (UDisksDaemon    *daemon,
 
   data.context = g_main_context_new ();
   g_main_context_push_thread_default (data.context);
-  data.loop = g_main_loop_new (data.context, FALSE);
-  data.success = FALSE;
-  data.status = 0;
-  data.message = NULL;
 
   va_start (var_args, command_line_format);
   command_line = g_strdup_vprintf (command_line_format, var_args);
@@ -1245,34 +1324,75 @@ udisks_daemon_launch_spawned_job_gstring_sync (UDisksDaemon    *daemon,
                                           input_string,
                                           "%s",
                                           command_line);
-  g_signal_connect (job,
-                    "spawned-job-completed",
-                    G_CALLBACK (spawned_job_sync_on_spawned_job_completed),
-                    &data);
-  g_signal_connect_after (job,
-                          "completed",
-                          G_CALLBACK (spawned_job_sync_on_completed),
-                          &data);
+  ret = spawned_job_run_sync (job, &data, out_status, out_message);
 
-  udisks_spawned_job_start (UDISKS_SPAWNED_JOB (job));
-  g_main_loop_run (data.loop);
+  g_free (command_line);
+  g_main_context_pop_thread_default (data.context);
+  g_main_context_unref (data.context);
 
-  if (out_status != NULL)
-    *out_status = data.status;
+  return ret;
+}
 
-  if (out_message != NULL)
-    *out_message = data.message;
-  else
-    g_free (data.message);
+/**
+ * udisks_daemon_launch_spawned_job_argv_sync:
+ * @daemon: A #UDisksDaemon.
+ * @object: (allow-none): A #UDisksObject to add to the job or %NULL.
+ * @job_operation: The operation for the job.
+ * @job_started_by_uid: The user who started the job.
+ * @cancellable: A #GCancellable or %NULL.
+ * @run_as_uid: The #uid_t to run the command as.
+ * @run_as_euid: The effective #uid_t to run the command as.
+ * @out_status: Return location for the @status parameter of the #UDisksSpawnedJob::spawned-job-completed signal.
+ * @out_message: Return location for the @message parameter of the #UDisksJob::completed signal.
+ * @input_string: A string to write to stdin of the spawned program or %NULL.
+ * @argv: (array zero-terminated=1): The program and its arguments to spawn.
+ *
+ * Like udisks_daemon_launch_spawned_job_argv() but blocks the calling
+ * thread until the job completes.
+ *
+ * Returns: The @success parameter of the #UDisksJob::completed signal.
+ *
+ * Since: 2.11.0
+ */
+gboolean
+udisks_daemon_launch_spawned_job_argv_sync (UDisksDaemon        *daemon,
+                                            UDisksObject        *object,
+                                            const gchar         *job_operation,
+                                            uid_t                job_started_by_uid,
+                                            GCancellable        *cancellable,
+                                            uid_t                run_as_uid,
+                                            uid_t                run_as_euid,
+                                            gint                *out_status,
+                                            gchar              **out_message,
+                                            GString             *input_string,
+                                            const gchar * const *argv)
+{
+  UDisksBaseJob *job;
+  SpawnedJobSyncData data;
+  gboolean ret;
+
+  g_return_val_if_fail (UDISKS_IS_DAEMON (daemon), FALSE);
+  g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), FALSE);
+  g_return_val_if_fail (argv != NULL && argv[0] != NULL, FALSE);
+
+  data.context = g_main_context_new ();
+  g_main_context_push_thread_default (data.context);
+
+  job = udisks_daemon_launch_spawned_job_argv (daemon,
+                                               object,
+                                               job_operation,
+                                               job_started_by_uid,
+                                               cancellable,
+                                               run_as_uid,
+                                               run_as_euid,
+                                               input_string,
+                                               argv);
+  ret = spawned_job_run_sync (job, &data, out_status, out_message);
 
-  g_free (command_line);
-  g_main_loop_unref (data.loop);
   g_main_context_pop_thread_default (data.context);
   g_main_context_unref (data.context);
 
-  /* note: the job object is freed in the ::completed handler */
-
-  return data.success;
+  return ret;
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
@@ -1292,7 +1412,7 @@ bd_thread_progress_callback (guint64            task_id,
           udisks_job_set_progress_valid (UDISKS_JOB (thread_job), TRUE);
         }
 
-      udisks_job_set_progress (UDISKS_JOB (thread_job), completion / 100.0);
+      udisks_base_job_set_progress (UDISKS_BASE_JOB (thread_job), completion / 100.0);
     }
 }
 
@@ -1366,6 +1486,191 @@ udisks_daemon_launch_threaded_job_sync (UDisksDaemon          *daemon,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+typedef struct
+{
+  UDisksBaseJob *job;
+  GCancellable *cancellable;
+  gulong cancelled_handler_id;
+  gint status;
+  GError *job_error;
+} RunJobData;
+
+static void
+run_job_data_free (RunJobData *data)
+{
+  if (data->cancelled_handler_id != 0)
+    g_cancellable_disconnect (data->cancellable, data->cancelled_handler_id);
+  g_clear_object (&data->cancellable);
+  g_clear_object (&data->job);
+  g_clear_error (&data->job_error);
+  g_free (data);
+}
+
+/* may be called in any thread */
+static void
+run_job_on_cancelled (GCancellable *cancellable,
+                      gpointer      user_data)
+{
+  UDisksBaseJob *job = UDISKS_BASE_JOB (user_data);
+
+  /* the job completes (as cancelled) on its own */
+  g_cancellable_cancel (udisks_base_job_get_cancellable (job));
+}
+
+static gboolean
+run_job_on_spawned_job_completed (UDisksSpawnedJob *job,
+                                  GError           *error,
+                                  gint              status,
+                                  GString          *standard_output,
+                                  GString          *standard_error,
+                                  gpointer          user_data)
+{
+  RunJobData *data = g_task_get_task_data (G_TASK (user_data));
+  data->status = status;
+  return FALSE; /* let other handlers run */
+}
+
+static gboolean
+run_job_on_threaded_job_completed (UDisksThreadedJob *job,
+                                   gboolean           result,
+                                   GError            *error,
+                                   gpointer           user_data)
+{
+  RunJobData *data = g_task_get_task_data (G_TASK (user_data));
+  if (!result && error != NULL)
+    data->job_error = g_error_copy (error);
+  return FALSE; /* let other handlers run */
+}
+
+static void
+run_job_on_completed (UDisksJob    *job,
+                      gboolean      success,
+                      const gchar  *message,
+                      gpointer      user_data)
+{
+  GTask *task = G_TASK (user_data);
+  RunJobData *data = g_task_get_task_data (task);
+
+  g_signal_handlers_disconnect_by_data (job, task);
+
+  if (success)
+    g_task_return_boolean (task, TRUE);
+  else if (data->job_error != NULL)
+    g_task_return_error (task, g_steal_pointer (&data->job_error));
+  else
+    g_task_return_new_error (task, UDISKS_ERROR, UDISKS_ERROR_FAILED, "%s", message);
+
+  g_object_unref (task);
+}
+
+/**
+ * udisks_daemon_run_job:
+ * @daemon: A #UDisksDaemon.
+ * @job: A #UDisksBaseJob returned by one of the udisks_daemon_launch_*_job() functions.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: Function to call when @job is completed.
+ * @user_data: User data to pass to @callback.
+ *
+ * Starts @job (unless it's a #UDisksSimpleJob which is completed by the
+ * caller) and asynchronously waits for it to complete. Unlike the
+ * udisks_daemon_launch_*_job_sync() functions this doesn't block the
+ * calling thread, so a method handler can chain further work in
+ * @callback and return right away.
+ *
+ * Cancelling @cancellable cancels @job. @callback is still only called
+ * once the job has actually completed.
+ *
+ * @callback is invoked in the <link linkend="g-main-context-push-thread-default">thread-default main loop</link>
+ * of the calling thread. Use udisks_daemon_run_job_finish() to get the result.
+ *
+ * Since: 2.11.0
+ */
+void
+udisks_daemon_run_job (UDisksDaemon        *daemon,
+                       UDisksBaseJob       *job,
+                       GCancellable        *cancellable,
+                       GAsyncReadyCallback  callback,
+                       gpointer             user_data)
+{
+  GTask *task;
+  RunJobData *data;
+
+  g_return_if_fail (UDISKS_IS_DAEMON (daemon));
+  g_return_if_fail (UDISKS_IS_BASE_JOB (job));
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  data = g_new0 (RunJobData, 1);
+  data->job = g_object_ref (job);
+
+  task = g_task_new (daemon, cancellable, callback, user_data);
+  g_task_set_source_tag (task, udisks_daemon_run_job);
+  g_task_set_task_data (task, data, (GDestroyNotify) run_job_data_free);
+
+  /* the task reference is released in run_job_on_completed() */
+  if (UDISKS_IS_SPAWNED_JOB (job))
+    g_signal_connect (job, "spawned-job-completed", G_CALLBACK (run_job_on_spawned_job_completed), task);
+  else if (UDISKS_IS_THREADED_JOB (job))
+    g_signal_connect (job, "threaded-job-completed", G_CALLBACK (run_job_on_threaded_job_completed), task);
+  /* the launcher has already connected the daemon's own handler that drops
+   * its job reference, so this one may run after it; the job is kept alive
+   * by the reference held in the task data, not by handler ordering */
+  g_signal_connect (job, "completed", G_CALLBACK (run_job_on_completed), task);
+
+  if (cancellable != NULL)
+    {
+      data->cancellable = g_object_ref (cancellable);
+      data->cancelled_handler_id = g_cancellable_connect (cancellable,
+                                                          G_CALLBACK (run_job_on_cancelled),
+                                                          job,
+                                                          NULL);
+    }
+
+  if (UDISKS_IS_SPAWNED_JOB (job))
+    udisks_spawned_job_start (UDISKS_SPAWNED_JOB (job));
+  else if (UDISKS_IS_THREADED_JOB (job))
+    udisks_threaded_job_start (UDISKS_THREADED_JOB (job));
+}
+
+/**
+ * udisks_daemon_run_job_finish:
+ * @daemon: A #UDisksDaemon.
+ * @result: The #GAsyncResult passed to the callback of udisks_daemon_run_job().
+ * @out_status: (out) (allow-none): Return location for the exit status of a #UDisksSpawnedJob or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with udisks_daemon_run_job().
+ *
+ * If the job failed, @error is set to the #GError of a #UDisksThreadedJob
+ * or to %UDISKS_ERROR_FAILED with the message passed to the
+ * #UDisksJob::completed signal. If the @cancellable passed to
+ * udisks_daemon_run_job() was cancelled, @error is set to
+ * %G_IO_ERROR_CANCELLED.
+ *
+ * Returns: %TRUE if the job succeeded, %FALSE if @error is set.
+ *
+ * Since: 2.11.0
+ */
+gboolean
+udisks_daemon_run_job_finish (UDisksDaemon  *daemon,
+                              GAsyncResult  *result,
+                              gint          *out_status,
+                              GError       **error)
+{
+  RunJobData *data;
+
+  g_return_val_if_fail (UDISKS_IS_DAEMON (daemon), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, daemon), FALSE);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == udisks_daemon_run_job, FALSE);
+
+  data = g_task_get_task_data (G_TASK (result));
+  if (out_status != NULL)
+    *out_status = data->status;
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
 typedef struct {
   GMainContext *context;
   GMainLoop *loop;
@@ -1594,6 +1899,384 @@ udisks_daemon_wait_for_object_to_disappear_sync (UDisksDaemon               *dae
   return NULL == object;
 }
 
+/* ---------------------------------------------------------------------------------------------------- */
+
+/* interval for rechecking in case an object changes without a uevent */
+#define WAIT_RECHECK_INTERVAL_MSEC 250
+
+typedef struct
+{
+  UDisksDaemon *daemon;
+  UDisksDaemonWaitFuncGeneric wait_func;
+  gpointer user_data;
+  GDestroyNotify user_data_free_func;
+  guint timeout_seconds;
+  gboolean to_disappear;
+  GSource *timeout_source;
+  GSource *recheck_source;
+  GSource *cancellable_source;
+  gulong uevent_probed_handler_id;
+  gulong object_added_handler_id;
+  gulong object_removed_handler_id;
+} WaitAsyncData;
+
+static void
+wait_async_data_free (WaitAsyncData *data)
+{
+  if (data->user_data_free_func != NULL)
+    data->user_data_free_func (data->user_data);
+  g_object_unref (data->daemon);
+  g_free (data);
+}
+
+static void
+wait_async_stop (WaitAsyncData *data)
+{
+  if (data->uevent_probed_handler_id != 0)
+    g_signal_handler_disconnect (data->daemon->linux_provider, data->uevent_probed_handler_id);
+  if (data->object_added_handler_id != 0)
+    g_signal_handler_disconnect (data->daemon->object_manager, data->object_added_handler_id);
+  if (data->object_removed_handler_id != 0)
+    g_signal_handler_disconnect (data->daemon->object_manager, data->object_removed_handler_id);
+  data->uevent_probed_handler_id = 0;
+  data->object_added_handler_id = 0;
+  data->object_removed_handler_id = 0;
+
+  if (data->timeout_source != NULL)
+    {
+      g_source_destroy (data->timeout_source);
+      g_clear_pointer (&data->timeout_source, g_source_unref);
+    }
+  if (data->recheck_source != NULL)
+    {
+      g_source_destroy (data->recheck_source);
+      g_clear_pointer (&data->recheck_source, g_source_unref);
+    }
+  if (data->cancellable_source != NULL)
+    {
+      g_source_destroy (data->cancellable_source);
+      g_clear_pointer (&data->cancellable_source, g_source_unref);
+    }
+}
+
+/* returns %TRUE if @task was completed */
+static gboolean
+wait_async_check (GTask *task)
+{
+  WaitAsyncData *data = g_task_get_task_data (task);
+  gpointer object;
+
+  object = data->wait_func (data->daemon, data->user_data);
+  if (data->to_disappear)
+    {
+      if (object != NULL)
+        {
+          g_object_unref (object);
+          return FALSE;
+        }
+      wait_async_stop (data);
+      g_task_return_boolean (task, TRUE);
+    }
+  else
+    {
+      if (object == NULL)
+        return FALSE;
+      wait_async_stop (data);
+      g_task_return_pointer (task, object, g_object_unref);
+    }
+
+  g_object_unref (task);
+  return TRUE;
+}
+
+static void
+wait_async_on_uevent_probed (UDisksLinuxProvider *provider,
+                             const gchar         *action,
+                             UDisksLinuxDevice   *device,
+                             gpointer             user_data)
+{
+  wait_async_check (G_TASK (user_data));
+}
+
+static void
+wait_async_on_object_changed (GDBusObjectManager *manager,
+                              GDBusObject        *object,
+                              gpointer            user_data)
+{
+  wait_async_check (G_TASK (user_data));
+}
+
+static gboolean
+wait_async_on_recheck (gpointer user_data)
+{
+  wait_async_check (G_TASK (user_data));
+  /* the source is destroyed if the task was completed */
+  return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+wait_async_on_timed_out (gpointer user_data)
+{
+  GTask *task = G_TASK (user_data);
+  WaitAsyncData *data = g_task_get_task_data (task);
+
+  wait_async_stop (data);
+  g_task_return_new_error (task, UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                           data->to_disappear ? "Timed out waiting" : "Timed out waiting for object");
+  g_object_unref (task);
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+wait_async_on_cancelled (GCancellable *cancellable,
+                         gpointer      user_data)
+{
+  GTask *task = G_TASK (user_data);
+  WaitAsyncData *data = g_task_get_task_data (task);
+
+  wait_async_stop (data);
+  g_task_return_error_if_cancelled (task);
+  g_object_unref (task);
+  return G_SOURCE_REMOVE;
+}
+
+static GSource *
+wait_async_attach (GSource     *source,
+                   GSourceFunc  func,
+                   GTask       *task)
+{
+  g_source_set_priority (source, G_PRIORITY_DEFAULT);
+  g_source_set_callback (source, func, task, NULL);
+  g_source_attach (source, NULL);
+  return source;
+}
+
+/* runs in the main thread where the objects are updated */
+static gboolean
+wait_async_start_in_idle (gpointer user_data)
+{
+  GTask *task = G_TASK (user_data);
+  WaitAsyncData *data = g_task_get_task_data (task);
+  GCancellable *cancellable = g_task_get_cancellable (task);
+
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_object_unref (task);
+      return G_SOURCE_REMOVE;
+    }
+
+  if (wait_async_check (task))
+    return G_SOURCE_REMOVE;
+
+  if (data->timeout_seconds == 0)
+    {
+      wait_async_on_timed_out (task);
+      return G_SOURCE_REMOVE;
+    }
+
+  /* recheck whenever objects may have changed */
+  data->uevent_probed_handler_id = g_signal_connect (data->daemon->linux_provider, "uevent-probed",
+                                                     G_CALLBACK (wait_async_on_uevent_probed), task);
+  data->object_added_handler_id = g_signal_connect (data->daemon->object_manager, "object-added",
+                                                    G_CALLBACK (wait_async_on_object_changed), task);
+  data->object_removed_handler_id = g_signal_connect (data->daemon->object_manager, "object-removed",
+                                                      G_CALLBACK (wait_async_on_object_changed), task);
+
+  data->timeout_source = wait_async_attach (g_timeout_source_new_seconds (data->timeout_seconds),
+                                            wait_async_on_timed_out, task);
+  data->recheck_source = wait_async_attach (g_timeout_source_new (WAIT_RECHECK_INTERVAL_MSEC),
+                                            wait_async_on_recheck, task);
+  if (cancellable != NULL)
+    {
+      data->cancellable_source = g_cancellable_source_new (cancellable);
+#if __GNUC__ >= 8
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-function-type"
+#endif
+      g_source_set_callback (data->cancellable_source, (GSourceFunc) wait_async_on_cancelled, task, NULL);
+#if __GNUC__ >= 8
+#pragma GCC diagnostic pop
+#endif
+      g_source_attach (data->cancellable_source, NULL);
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+wait_for_object_async (UDisksDaemon                *daemon,
+                       UDisksDaemonWaitFuncGeneric  wait_func,
+                       gpointer                     user_data,
+                       GDestroyNotify               user_data_free_func,
+                       guint                        timeout_seconds,
+                       gboolean                     to_disappear,
+                       GCancellable                *cancellable,
+                       GAsyncReadyCallback          callback,
+                       gpointer                     callback_user_data,
+                       gpointer                     source_tag)
+{
+  WaitAsyncData *data;
+  GTask *task;
+
+  data = g_new0 (WaitAsyncData, 1);
+  data->daemon = g_object_ref (daemon);
+  data->wait_func = wait_func;
+  data->user_data = user_data;
+  data->user_data_free_func = user_data_free_func;
+  data->timeout_seconds = timeout_seconds;
+  data->to_disappear = to_disappear;
+
+  task = g_task_new (daemon, cancellable, callback, callback_user_data);
+  g_task_set_source_tag (task, source_tag);
+  g_task_set_task_data (task, data, (GDestroyNotify) wait_async_data_free);
+
+  /* all the checking is done in the main loop so that no locking is needed
+   * and the objects don't change while @wait_func is looking at them - the
+   * task reference is released once it's completed
+   */
+  g_main_context_invoke (NULL, wait_async_start_in_idle, task);
+}
+
+/**
+ * udisks_daemon_wait_for_object:
+ * @daemon: A #UDisksDaemon.
+ * @wait_func: Function to check for desired object.
+ * @user_data: User data to pass to @wait_func.
+ * @user_data_free_func: (allow-none): Function to free @user_data or %NULL.
+ * @timeout_seconds: Maximum time to wait for the object (in seconds) or 0 to never wait.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: Function to call when the object is available or the wait failed.
+ * @callback_user_data: User data to pass to @callback.
+ *
+ * Asynchronous version of udisks_daemon_wait_for_object_sync(). Instead
+ * of polling in a private main loop, @wait_func is called in the main
+ * thread whenever a uevent was processed or an object was added or
+ * removed (and periodically as a fallback), so this can be used from any
+ * thread, including the main one, without blocking it.
+ *
+ * @callback is invoked in the <link linkend="g-main-context-push-thread-default">thread-default main loop</link>
+ * of the calling thread. Use udisks_daemon_wait_for_object_finish() to get the result.
+ *
+ * Since: 2.11.0
+ */
+void
+udisks_daemon_wait_for_object (UDisksDaemon               *daemon,
+                               UDisksDaemonWaitFuncObject  wait_func,
+                               gpointer                    user_data,
+                               GDestroyNotify              user_data_free_func,
+                               guint                       timeout_seconds,
+                               GCancellable               *cancellable,
+                               GAsyncReadyCallback         callback,
+                               gpointer                    callback_user_data)
+{
+  g_return_if_fail (UDISKS_IS_DAEMON (daemon));
+  g_return_if_fail (wait_func != NULL);
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  wait_for_object_async (daemon,
+                         (UDisksDaemonWaitFuncGeneric) wait_func,
+                         user_data,
+                         user_data_free_func,
+                         timeout_seconds,
+                         FALSE, /* to_disappear */
+                         cancellable,
+                         callback,
+                         callback_user_data,
+                         udisks_daemon_wait_for_object);
+}
+
+/**
+ * udisks_daemon_wait_for_object_finish:
+ * @daemon: A #UDisksDaemon.
+ * @result: The #GAsyncResult passed to the callback of udisks_daemon_wait_for_object().
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with udisks_daemon_wait_for_object().
+ *
+ * Returns: (transfer full): The object picked by @wait_func or %NULL if @error is set.
+ *
+ * Since: 2.11.0
+ */
+UDisksObject *
+udisks_daemon_wait_for_object_finish (UDisksDaemon  *daemon,
+                                      GAsyncResult  *result,
+                                      GError       **error)
+{
+  g_return_val_if_fail (UDISKS_IS_DAEMON (daemon), NULL);
+  g_return_val_if_fail (g_task_is_valid (result, daemon), NULL);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == udisks_daemon_wait_for_object, NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * udisks_daemon_wait_for_object_to_disappear:
+ * @daemon: A #UDisksDaemon.
+ * @wait_func: Function to check for desired object.
+ * @user_data: User data to pass to @wait_func.
+ * @user_data_free_func: (allow-none): Function to free @user_data or %NULL.
+ * @timeout_seconds: Maximum time to wait for the object to disappear (in seconds) or 0 to never wait.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: Function to call when the object disappeared or the wait failed.
+ * @callback_user_data: User data to pass to @callback.
+ *
+ * Asynchronous version of udisks_daemon_wait_for_object_to_disappear_sync(),
+ * see udisks_daemon_wait_for_object() for details.
+ *
+ * Use udisks_daemon_wait_for_object_to_disappear_finish() to get the result.
+ *
+ * Since: 2.11.0
+ */
+void
+udisks_daemon_wait_for_object_to_disappear (UDisksDaemon               *daemon,
+                                            UDisksDaemonWaitFuncObject  wait_func,
+                                            gpointer                    user_data,
+                                            GDestroyNotify              user_data_free_func,
+                                            guint                       timeout_seconds,
+                                            GCancellable               *cancellable,
+                                            GAsyncReadyCallback         callback,
+                                            gpointer                    callback_user_data)
+{
+  g_return_if_fail (UDISKS_IS_DAEMON (daemon));
+  g_return_if_fail (wait_func != NULL);
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  wait_for_object_async (daemon,
+                         (UDisksDaemonWaitFuncGeneric) wait_func,
+                         user_data,
+                         user_data_free_func,
+                         timeout_seconds,
+                         TRUE, /* to_disappear */
+                         cancellable,
+                         callback,
+                         callback_user_data,
+                         udisks_daemon_wait_for_object_to_disappear);
+}
+
+/**
+ * udisks_daemon_wait_for_object_to_disappear_finish:
+ * @daemon: A #UDisksDaemon.
+ * @result: The #GAsyncResult passed to the callback of udisks_daemon_wait_for_object_to_disappear().
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with udisks_daemon_wait_for_object_to_disappear().
+ *
+ * Returns: %TRUE if the object disappeared, %FALSE if @error is set.
+ *
+ * Since: 2.11.0
+ */
+gboolean
+udisks_daemon_wait_for_object_to_disappear_finish (UDisksDaemon  *daemon,
+                                                   GAsyncResult  *result,
+                                                   GError       **error)
+{
+  g_return_val_if_fail (UDISKS_IS_DAEMON (daemon), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, daemon), FALSE);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == udisks_daemon_wait_for_object_to_disappear, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 
 /* ---------------------------------------------------------------------------------------------------- */
 
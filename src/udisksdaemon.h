@@ -89,6 +89,29 @@ gboolean             udisks_daemon_wait_for_object_to_disappear_sync (UDisksDaem
                                                                       guint                       timeout_seconds,
                                                                       GError                      **error);
 
+void                      udisks_daemon_wait_for_object       (UDisksDaemon               *daemon,
+                                                               UDisksDaemonWaitFuncObject  wait_func,
+                                                               gpointer                    user_data,
+                                                               GDestroyNotify              user_data_free_func,
+                                                               guint                       timeout_seconds,
+                                                               GCancellable               *cancellable,
+                                                               GAsyncReadyCallback         callback,
+                                                               gpointer                    callback_user_data);
+UDisksObject             *udisks_daemon_wait_for_object_finish (UDisksDaemon  *daemon,
+                                                                GAsyncResult  *result,
+                                                                GError       **error);
+void                      udisks_daemon_wait_for_object_to_disappear (UDisksDaemon               *daemon,
+                                                                      UDisksDaemonWaitFuncObject  wait_func,
+                                                                      gpointer                    user_data,
+                                                                      GDestroyNotify              user_data_free_func,
+                                                                      guint                       timeout_seconds,
+                                                                      GCancellable               *cancellable,
+                                                                      GAsyncReadyCallback         callback,
+                                                                      gpointer                    callback_user_data);
+gboolean                  udisks_daemon_wait_for_object_to_disappear_finish (UDisksDaemon  *daemon,
+                                                                             GAsyncResult  *result,
+                                                                             GError       **error);
+
 GList                    *udisks_daemon_get_objects           (UDisksDaemon         *daemon);
 
 UDisksObject             *udisks_daemon_find_block            (UDisksDaemon         *daemon,
@@ -155,6 +178,35 @@ gboolean                  udisks_daemon_launch_spawned_job_gstring_sync (UDisksD
                                                                  GString         *input_string,
                                                                  const gchar     *command_line_format,
                                                                  ...) G_GNUC_PRINTF (11, 12);
+UDisksBaseJob            *udisks_daemon_launch_spawned_job_argv (UDisksDaemon        *daemon,
+                                                                 UDisksObject        *object,
+                                                                 const gchar         *job_operation,
+                                                                 uid_t                job_started_by_uid,
+                                                                 GCancellable        *cancellable,
+                                                                 uid_t                run_as_uid,
+                                                                 uid_t                run_as_euid,
+                                                                 GString             *input_string,
+                                                                 const gchar * const *argv);
+gboolean                  udisks_daemon_launch_spawned_job_argv_sync (UDisksDaemon        *daemon,
+                                                                      UDisksObject        *object,
+                                                                      const gchar         *job_operation,
+                                                                      uid_t                job_started_by_uid,
+                                                                      GCancellable        *cancellable,
+                                                                      uid_t                run_as_uid,
+                                                                      uid_t                run_as_euid,
+                                                                      gint                *out_status,
+                                                                      gchar              **out_message,
+                                                                      GString             *input_string,
+                                                                      const gchar * const *argv);
+void                      udisks_daemon_run_job               (UDisksDaemon        *daemon,
+                                                               UDisksBaseJob       *job,
+                                                               GCancellable        *cancellable,
+                                                               GAsyncReadyCallback  callback,
+                                                               gpointer             user_data);
+gboolean                  udisks_daemon_run_job_finish        (UDisksDaemon  *daemon,
+                                                               GAsyncResult  *result,
+                                                               gint          *out_status,
+                                                               GError       **error);
 UDisksBaseJob            *udisks_daemon_launch_threaded_job   (UDisksDaemon          *daemon,
                                                                UDisksObject          *object,
                                                                const gchar           *job_operation,
@@ -1827,6 +1827,9 @@ resolve_uevent_path (UDisksDaemon *daemon,
  * The triggered event will bubble up from the kernel through the udev
  * stack and will eventually be received by the udisks daemon process
  * itself. This method does not wait for the event to be received.
+ *
+ * On kernels supporting synthetic uevent tagging the uevent is tagged
+ * with the daemon UUID so that it's always processed in full.
  */
 void
 udisks_daemon_util_trigger_uevent (UDisksDaemon *daemon,
@@ -1834,12 +1837,23 @@ udisks_daemon_util_trigger_uevent (UDisksDaemon *daemon,
                                    const gchar  *sysfs_path)
 {
   gchar *path;
+  gchar *str;
 
   g_return_if_fail (UDISKS_IS_DAEMON (daemon));
   g_return_if_fail (device_file != NULL || sysfs_path != NULL);
 
   path = resolve_uevent_path (daemon, device_file, sysfs_path);
-  trigger_uevent (path, "change");
+  if (bd_utils_check_linux_version (4, 13, 0) < 0)
+    {
+      trigger_uevent (path, "change");
+    }
+  else
+    {
+      str = g_strdup_printf ("change %s", udisks_daemon_get_uuid (daemon));
+      if (! trigger_uevent (path, str))
+        trigger_uevent (path, "change");
+      g_free (str);
+    }
   g_free (path);
 }
 
@@ -1959,3 +1973,90 @@ udisks_module_validate_name (const gchar *module_name)
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
+
+/* Only ever touched from the main thread, see udisks_daemon_util_flush_interface() */
+static guint flush_freeze_count = 0;
+static GHashTable *flush_pending = NULL;
+
+/**
+ * udisks_daemon_util_freeze_flush:
+ *
+ * Starts batching of D-Bus property change notifications. Until the
+ * matching udisks_daemon_util_thaw_flush() call, interfaces passed to
+ * udisks_daemon_util_flush_interface() from the main thread are not
+ * flushed immediately but collected and flushed only once when the
+ * batch ends. This way, a burst of uevents for the same object results
+ * in a single <literal>PropertiesChanged</literal> signal per interface
+ * carrying the final values.
+ *
+ * Calls may be nested. Must be called from the main thread.
+ */
+void
+udisks_daemon_util_freeze_flush (void)
+{
+  g_return_if_fail (g_main_context_is_owner (g_main_context_default ()));
+
+  if (flush_pending == NULL)
+    flush_pending = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref, NULL);
+  flush_freeze_count++;
+}
+
+/**
+ * udisks_daemon_util_thaw_flush:
+ *
+ * Ends a batch started with udisks_daemon_util_freeze_flush(). When the
+ * outermost batch ends, all interfaces collected in the meantime are
+ * flushed.
+ *
+ * Must be called from the main thread.
+ */
+void
+udisks_daemon_util_thaw_flush (void)
+{
+  GHashTable *pending;
+  GHashTableIter iter;
+  gpointer iface;
+
+  g_return_if_fail (g_main_context_is_owner (g_main_context_default ()));
+  g_return_if_fail (flush_freeze_count > 0);
+
+  if (--flush_freeze_count > 0)
+    return;
+
+  /* swap the table out in case flushing re-enters us */
+  pending = flush_pending;
+  flush_pending = NULL;
+
+  g_hash_table_iter_init (&iter, pending);
+  while (g_hash_table_iter_next (&iter, &iface, NULL))
+    g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (iface));
+  g_hash_table_unref (pending);
+}
+
+/**
+ * udisks_daemon_util_flush_interface:
+ * @iface: A #GDBusInterfaceSkeleton.
+ *
+ * Like g_dbus_interface_skeleton_flush() but defers the flush until the
+ * end of the current batch if called from the main thread while
+ * property notifications are frozen, see udisks_daemon_util_freeze_flush().
+ *
+ * This should be used at the end of functions updating interfaces as a
+ * result of uevent processing. Method handlers that need the changes to
+ * be on the bus before replying should keep using
+ * g_dbus_interface_skeleton_flush().
+ */
+void
+udisks_daemon_util_flush_interface (gpointer iface)
+{
+  g_return_if_fail (G_IS_DBUS_INTERFACE_SKELETON (iface));
+
+  if (g_main_context_is_owner (g_main_context_default ()) && flush_freeze_count > 0)
+    {
+      if (!g_hash_table_contains (flush_pending, iface))
+        g_hash_table_add (flush_pending, g_object_ref (iface));
+      return;
+    }
+
+  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (iface));
+}
@@ -137,6 +137,10 @@ guint16 udisks_ata_identify_get_word (const guchar *identify_data, guint word_nu
 
 gboolean udisks_module_validate_name (const gchar *module_name);
 
+void udisks_daemon_util_freeze_flush    (void);
+void udisks_daemon_util_thaw_flush      (void);
+void udisks_daemon_util_flush_interface (gpointer iface);
+
 /* Utility macro for policy verification. */
 #define UDISKS_DAEMON_CHECK_AUTHORIZATION(daemon,                   \
                                           object,                   \
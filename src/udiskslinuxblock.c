@@ -47,6 +47,7 @@
 
 #include "udiskslogging.h"
 #include "udiskslinuxblock.h"
+#include "udiskslinuxblockbenchmark.h"
 #include "udiskslinuxblockobject.h"
 #include "udiskslinuxdriveobject.h"
 #include "udisksdaemon.h"
@@ -747,7 +748,7 @@ update_configuration (UDisksLinuxBlock  *block,
       configuration = g_variant_new ("a(sa{sv})", NULL);
     }
   udisks_block_set_configuration (UDISKS_BLOCK (block), configuration);
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (block));
+  udisks_daemon_util_flush_interface (block);
 }
 
 static void
@@ -1264,7 +1265,7 @@ udisks_linux_block_update (UDisksLinuxBlock       *block,
   update_mdraid (block, device, drive, object_manager);
 
  out:
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (block));
+  udisks_daemon_util_flush_interface (block);
   if (device != NULL)
     g_object_unref (device);
   if (drive != NULL)
@@ -2452,7 +2453,6 @@ erase_device (UDisksBlock   *block,
   guint64 size;
   guint64 pos;
   guchar *buf = NULL;
-  gint64 time_of_last_signal;
   GError *local_error = NULL;
 
   if (g_strcmp0 (erase_type, "ata-secure-erase") == 0)
@@ -2484,6 +2484,8 @@ erase_device (UDisksBlock   *block,
 
   job = udisks_daemon_launch_simple_job (daemon, object, "format-erase", caller_uid, NULL);
   udisks_base_job_set_auto_estimate (UDISKS_BASE_JOB (job), TRUE);
+  /* writes are flushed in bursts (O_SYNC), smooth the estimate more */
+  udisks_base_job_set_rate_smoothing (UDISKS_BASE_JOB (job), 0.1);
   udisks_job_set_progress_valid (UDISKS_JOB (job), TRUE);
 
   if (ioctl (fd, BLKGETSIZE64, &size) != 0)
@@ -2497,12 +2499,10 @@ erase_device (UDisksBlock   *block,
 
   buf = g_new0 (guchar, ERASE_SIZE);
   pos = 0;
-  time_of_last_signal = g_get_monotonic_time ();
   while (pos < size)
     {
       size_t to_write;
       ssize_t num_written;
-      gint64 now;
 
       to_write = MIN (size - pos, ERASE_SIZE);
     again:
@@ -2525,14 +2525,7 @@ erase_device (UDisksBlock   *block,
           goto out;
         }
 
-      /* only emit D-Bus signal at most once a second */
-      now = g_get_monotonic_time ();
-      if (now - time_of_last_signal > G_USEC_PER_SEC)
-        {
-          /* TODO: estimation etc. */
-          udisks_job_set_progress (UDISKS_JOB (job), ((gdouble) pos) / size);
-          time_of_last_signal = now;
-        }
+      udisks_base_job_set_progress (UDISKS_BASE_JOB (job), ((gdouble) pos) / size);
     }
 
   ret = TRUE;
@@ -4096,6 +4089,160 @@ handle_open_for_benchmark (UDisksBlock           *block,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+/* runs in thread dedicated to handling @invocation */
+static gboolean
+handle_benchmark (UDisksBlock           *block,
+                  GDBusMethodInvocation *invocation,
+                  GVariant              *options)
+{
+  UDisksObject *object;
+  UDisksDaemon *daemon;
+  UDisksState *state = NULL;
+  UDisksBenchmarkData data = { 0, };
+  const gchar *action_id;
+  const gchar *message;
+  const gchar *pattern = "seq-read";
+  gboolean known_pattern;
+  gboolean is_write;
+  gboolean success;
+  uid_t caller_uid;
+  GError *error = NULL;
+
+  object = udisks_daemon_util_dup_object (block, &error);
+  if (object == NULL)
+    {
+      g_dbus_method_invocation_take_error (invocation, error);
+      goto out;
+    }
+
+  daemon = udisks_linux_block_object_get_daemon (UDISKS_LINUX_BLOCK_OBJECT (object));
+  state = udisks_daemon_get_state (daemon);
+
+  udisks_linux_block_object_lock_for_cleanup (UDISKS_LINUX_BLOCK_OBJECT (object));
+  udisks_state_check_block (state, udisks_linux_block_object_get_device_number (UDISKS_LINUX_BLOCK_OBJECT (object)));
+
+  /* Unknown patterns are only rejected once the caller is authorized; until
+   * then, assume the worst and require the write benchmark authorization.
+   */
+  g_variant_lookup (options, "pattern", "&s", &pattern);
+  known_pattern = udisks_linux_block_benchmark_parse_pattern (pattern, &data.pattern);
+  is_write = !known_pattern ||
+             data.pattern == UDISKS_BENCHMARK_PATTERN_SEQ_WRITE ||
+             data.pattern == UDISKS_BENCHMARK_PATTERN_RAND_WRITE;
+
+  if (!udisks_daemon_util_get_caller_uid_sync (daemon, invocation, NULL /* GCancellable */, &caller_uid, &error))
+    {
+      g_dbus_method_invocation_return_gerror (invocation, error);
+      g_clear_error (&error);
+      goto out;
+    }
+
+  if (is_write)
+    {
+      action_id = "org.freedesktop.udisks2.modify-device";
+      if (udisks_block_get_hint_system (block))
+        action_id = "org.freedesktop.udisks2.modify-device-system";
+      /* Translators: Shown in authentication dialog when an application
+       * wants to run a destructive benchmark on a device.
+       *
+       * Do not translate $(drive), it's a placeholder and will
+       * be replaced by the name of the drive/device in question
+       */
+      message = N_("Authentication is required to run a write benchmark on $(drive)");
+    }
+  else
+    {
+      action_id = "org.freedesktop.udisks2.open-device";
+      if (udisks_block_get_hint_system (block))
+        action_id = "org.freedesktop.udisks2.open-device-system";
+      /* Translators: Shown in authentication dialog when an application
+       * wants to benchmark a device.
+       *
+       * Do not translate $(drive), it's a placeholder and will
+       * be replaced by the name of the drive/device in question
+       */
+      message = N_("Authentication is required to open $(drive) for benchmarking");
+    }
+
+  if (!udisks_daemon_util_check_authorization_sync (daemon,
+                                                    object,
+                                                    action_id,
+                                                    options,
+                                                    message,
+                                                    invocation))
+    goto out;
+
+  if (!known_pattern)
+    {
+      g_dbus_method_invocation_return_error (invocation, UDISKS_ERROR, UDISKS_ERROR_OPTION_NOT_PERMITTED,
+                                             "Unknown benchmark pattern `%s'", pattern);
+      goto out;
+    }
+
+  data.device = udisks_block_get_device (block);
+  data.block_size = (data.pattern == UDISKS_BENCHMARK_PATTERN_SEQ_READ ||
+                     data.pattern == UDISKS_BENCHMARK_PATTERN_SEQ_WRITE) ? 1024 * 1024 : 4096;
+  data.queue_depth = 1;
+  data.runtime = 10;
+  g_variant_lookup (options, "block-size", "t", &data.block_size);
+  g_variant_lookup (options, "queue-depth", "u", &data.queue_depth);
+  g_variant_lookup (options, "runtime", "u", &data.runtime);
+  g_variant_lookup (options, "region-size", "t", &data.region_size);
+
+  success = udisks_daemon_launch_threaded_job_sync (daemon,
+                                                    object,
+                                                    "block-benchmark",
+                                                    caller_uid,
+                                                    udisks_linux_block_benchmark_job_func,
+                                                    &data,
+                                                    NULL, /* user_data_free_func */
+                                                    NULL, /* cancellable */
+                                                    &error);
+
+  /* A write benchmark overwrites whatever was on the device, even when it
+   * fails part way through - so make sure the partition table and the probed
+   * filesystem information are refreshed
+   */
+  if (is_write)
+    {
+      UDisksLinuxDevice *device;
+      GError *l_error = NULL;
+
+      device = udisks_linux_block_object_get_device (UDISKS_LINUX_BLOCK_OBJECT (object));
+      if (g_strcmp0 (g_udev_device_get_devtype (device->udev_device), "disk") == 0 &&
+          !udisks_linux_block_object_reread_partition_table (UDISKS_LINUX_BLOCK_OBJECT (object), &l_error))
+        {
+          udisks_warning ("%s", l_error->message);
+          g_clear_error (&l_error);
+        }
+      g_object_unref (device);
+      udisks_linux_block_object_trigger_uevent_sync (UDISKS_LINUX_BLOCK_OBJECT (object),
+                                                     UDISKS_DEFAULT_WAIT_TIMEOUT);
+    }
+
+  if (!success)
+    {
+      g_dbus_method_invocation_return_error (invocation, UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                                             "Error benchmarking %s: %s",
+                                             udisks_block_get_device (block),
+                                             error->message);
+      g_clear_error (&error);
+      goto out;
+    }
+
+  udisks_block_complete_benchmark (block, invocation, data.results);
+
+ out:
+  if (object != NULL)
+    udisks_linux_block_object_release_cleanup_lock (UDISKS_LINUX_BLOCK_OBJECT (object));
+  if (state != NULL)
+    udisks_state_check (state);
+  g_clear_object (&object);
+  return TRUE; /* returning true means that we handled the method invocation */
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
 static gboolean
 handle_open_device (UDisksBlock           *block,
                     GDBusMethodInvocation *invocation,
@@ -4319,6 +4466,7 @@ block_iface_init (UDisksBlockIface *iface)
   iface->handle_open_for_backup           = handle_open_for_backup;
   iface->handle_open_for_restore          = handle_open_for_restore;
   iface->handle_open_for_benchmark        = handle_open_for_benchmark;
+  iface->handle_benchmark                 = handle_benchmark;
   iface->handle_open_device               = handle_open_device;
   iface->handle_rescan                    = handle_rescan;
   iface->handle_restore_encrypted_header  = handle_restore_encrypted_header;
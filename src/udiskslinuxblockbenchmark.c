@@ -0,0 +1,504 @@
+/* -*- mode: C; c-file-style: "gnu"; indent-tabs-mode: nil; -*-
+ *
+ * Copyright (C) 2024 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#define _GNU_SOURCE /* for O_DIRECT */
+
+#include "config.h"
+#include <glib/gi18n-lib.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <linux/fs.h>
+
+#include "udiskslogging.h"
+#include "udisksthreadedjob.h"
+#include "udiskslinuxblockbenchmark.h"
+
+/**
+ * SECTION:udiskslinuxblockbenchmark
+ * @title: Block device benchmark
+ * @short_description: I/O benchmark engine for block devices
+ *
+ * Runs a fixed-duration I/O benchmark on a block device. The engine keeps
+ * @queue_depth requests in flight by running one worker thread per
+ * outstanding request, each issuing <literal>O_DIRECT</literal> I/O, and
+ * collects throughput and a latency histogram from which percentiles are
+ * derived.
+ */
+
+/* Each request in flight costs a daemon thread, so keep this small */
+#define BENCHMARK_MAX_QUEUE_DEPTH 32
+#define BENCHMARK_MAX_RUNTIME     3600
+#define BENCHMARK_MAX_BLOCK_SIZE  (64 * 1024 * 1024)
+#define BENCHMARK_BUF_ALIGNMENT   4096
+
+/* Latency histogram with 16 linear sub-buckets per power of two, i.e. the
+ * reported percentiles are accurate to within ~6%.
+ */
+#define LATENCY_SUB_BUCKETS 16
+#define LATENCY_NUM_BUCKETS (LATENCY_SUB_BUCKETS * 60)
+
+/* how many requests a worker completes before publishing its counters */
+#define WORKER_FLUSH_INTERVAL 64
+
+typedef struct
+{
+  guint64 ios;
+  guint64 bytes;
+  guint64 latency_sum;
+  guint64 latency_min;
+  guint64 latency_max;
+  guint64 histogram[LATENCY_NUM_BUCKETS];
+} BenchmarkStats;
+
+typedef struct
+{
+  UDisksBenchmarkData *data;
+  gint                 fd;
+  gboolean             is_write;
+  gboolean             is_random;
+  guint64              num_blocks;
+  gint64               deadline;
+  gint                 stop;           /* atomic */
+
+  GMutex               lock;
+  guint64              next_block;     /* protected by lock */
+  BenchmarkStats       stats;          /* protected by lock */
+  GError              *error;          /* protected by lock */
+} BenchmarkState;
+
+static guint
+latency_to_bucket (guint64 usec)
+{
+  guint msb;
+  guint idx;
+
+  if (usec < LATENCY_SUB_BUCKETS)
+    return usec;
+
+  msb = g_bit_storage (usec) - 1;
+  idx = (msb - 3) * LATENCY_SUB_BUCKETS + ((usec >> (msb - 4)) & (LATENCY_SUB_BUCKETS - 1));
+
+  return MIN (idx, LATENCY_NUM_BUCKETS - 1);
+}
+
+static guint64
+bucket_to_latency (guint idx)
+{
+  guint msb;
+
+  if (idx < LATENCY_SUB_BUCKETS)
+    return idx;
+
+  msb = idx / LATENCY_SUB_BUCKETS + 3;
+  return ((guint64) (LATENCY_SUB_BUCKETS + idx % LATENCY_SUB_BUCKETS)) << (msb - 4);
+}
+
+static void
+stats_init (BenchmarkStats *stats)
+{
+  memset (stats, 0, sizeof (BenchmarkStats));
+  stats->latency_min = G_MAXUINT64;
+}
+
+static void
+stats_merge (BenchmarkStats       *dest,
+             const BenchmarkStats *src)
+{
+  guint n;
+
+  dest->ios += src->ios;
+  dest->bytes += src->bytes;
+  dest->latency_sum += src->latency_sum;
+  dest->latency_min = MIN (dest->latency_min, src->latency_min);
+  dest->latency_max = MAX (dest->latency_max, src->latency_max);
+  for (n = 0; n < LATENCY_NUM_BUCKETS; n++)
+    dest->histogram[n] += src->histogram[n];
+}
+
+static guint64
+stats_get_percentile (const BenchmarkStats *stats,
+                      gdouble               percentile)
+{
+  guint64 target;
+  guint64 count = 0;
+  guint n;
+
+  if (stats->ios == 0)
+    return 0;
+
+  target = (guint64) (stats->ios * percentile / 100.0);
+  if (target == 0)
+    target = 1;
+
+  for (n = 0; n < LATENCY_NUM_BUCKETS; n++)
+    {
+      count += stats->histogram[n];
+      if (count >= target)
+        return MIN (MAX (bucket_to_latency (n), stats->latency_min), stats->latency_max);
+    }
+
+  return stats->latency_max;
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+static void
+benchmark_set_error (BenchmarkState *state,
+                     GError         *error)
+{
+  g_mutex_lock (&state->lock);
+  if (state->error == NULL)
+    state->error = error;
+  else
+    g_error_free (error);
+  g_mutex_unlock (&state->lock);
+
+  g_atomic_int_set (&state->stop, 1);
+}
+
+static gpointer
+benchmark_worker_func (gpointer user_data)
+{
+  BenchmarkState *state = user_data;
+  guint64 block_size = state->data->block_size;
+  BenchmarkStats *local;
+  GRand *rand;
+  guchar *buf = NULL;
+  guint64 block;
+  guint n;
+
+  local = g_new (BenchmarkStats, 1);
+  stats_init (local);
+  rand = g_rand_new ();
+
+  if (posix_memalign ((void **) &buf, BENCHMARK_BUF_ALIGNMENT, block_size) != 0)
+    {
+      benchmark_set_error (state, g_error_new (UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                                               "Error allocating %" G_GUINT64_FORMAT " bytes for benchmark buffer",
+                                               block_size));
+      goto out;
+    }
+
+  /* use incompressible data so that the device can't take shortcuts */
+  for (n = 0; n + sizeof (guint32) <= block_size; n += sizeof (guint32))
+    *((guint32 *) (buf + n)) = g_rand_int (rand);
+
+  while (!g_atomic_int_get (&state->stop))
+    {
+      ssize_t num;
+      gint64 start;
+      guint64 latency;
+
+      if (g_get_monotonic_time () >= state->deadline)
+        break;
+
+      if (state->is_random)
+        {
+          block = (((guint64) g_rand_int (rand)) << 32 | g_rand_int (rand)) % state->num_blocks;
+        }
+      else
+        {
+          g_mutex_lock (&state->lock);
+          block = state->next_block++;
+          if (state->next_block >= state->num_blocks)
+            state->next_block = 0;
+          g_mutex_unlock (&state->lock);
+        }
+
+      start = g_get_monotonic_time ();
+    again:
+      if (state->is_write)
+        num = pwrite (state->fd, buf, block_size, block * block_size);
+      else
+        num = pread (state->fd, buf, block_size, block * block_size);
+      if (num == -1 && errno == EINTR)
+        goto again;
+      if (num != (ssize_t) block_size)
+        {
+          benchmark_set_error (state, g_error_new (UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                                                   "Error %s %" G_GUINT64_FORMAT " bytes at offset %" G_GUINT64_FORMAT " on %s: %s",
+                                                   state->is_write ? "writing" : "reading",
+                                                   block_size, block * block_size, state->data->device,
+                                                   num == -1 ? g_strerror (errno) : "short transfer"));
+          break;
+        }
+      latency = g_get_monotonic_time () - start;
+
+      local->ios++;
+      local->bytes += block_size;
+      local->latency_sum += latency;
+      local->latency_min = MIN (local->latency_min, latency);
+      local->latency_max = MAX (local->latency_max, latency);
+      local->histogram[latency_to_bucket (latency)]++;
+
+      if (local->ios % WORKER_FLUSH_INTERVAL == 0)
+        {
+          g_mutex_lock (&state->lock);
+          stats_merge (&state->stats, local);
+          g_mutex_unlock (&state->lock);
+          stats_init (local);
+        }
+    }
+
+  g_mutex_lock (&state->lock);
+  stats_merge (&state->stats, local);
+  g_mutex_unlock (&state->lock);
+
+ out:
+  free (buf);
+  g_rand_free (rand);
+  g_free (local);
+  return NULL;
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+/**
+ * udisks_linux_block_benchmark_parse_pattern:
+ * @str: A pattern name, e.g. <literal>rand-read</literal>.
+ * @out_pattern: (out): Return location for the parsed pattern.
+ *
+ * Parses the pattern name used in the <literal>pattern</literal> option
+ * of the Block.Benchmark() method.
+ *
+ * Returns: %TRUE if @str is a known pattern, %FALSE otherwise.
+ */
+gboolean
+udisks_linux_block_benchmark_parse_pattern (const gchar            *str,
+                                            UDisksBenchmarkPattern *out_pattern)
+{
+  if (g_strcmp0 (str, "seq-read") == 0)
+    *out_pattern = UDISKS_BENCHMARK_PATTERN_SEQ_READ;
+  else if (g_strcmp0 (str, "seq-write") == 0)
+    *out_pattern = UDISKS_BENCHMARK_PATTERN_SEQ_WRITE;
+  else if (g_strcmp0 (str, "rand-read") == 0)
+    *out_pattern = UDISKS_BENCHMARK_PATTERN_RAND_READ;
+  else if (g_strcmp0 (str, "rand-write") == 0)
+    *out_pattern = UDISKS_BENCHMARK_PATTERN_RAND_WRITE;
+  else
+    return FALSE;
+
+  return TRUE;
+}
+
+/**
+ * udisks_linux_block_benchmark_job_func:
+ * @job: A #UDisksThreadedJob.
+ * @cancellable: A #GCancellable.
+ * @user_data: A #UDisksBenchmarkData.
+ * @error: Return location for error.
+ *
+ * A #UDisksThreadedJobFunc running the benchmark described by @user_data.
+ * While running, the job progress, rate and expected end time are updated
+ * once a second. On success the results are stored as a floating
+ * <literal>a{sv}</literal> #GVariant in the <structfield>results</structfield>
+ * member of @user_data.
+ *
+ * Returns: %TRUE if the benchmark completed, %FALSE with @error set otherwise.
+ */
+gboolean
+udisks_linux_block_benchmark_job_func (UDisksThreadedJob  *job,
+                                       GCancellable       *cancellable,
+                                       gpointer            user_data,
+                                       GError            **error)
+{
+  UDisksBenchmarkData *data = user_data;
+  BenchmarkState state = { 0, };
+  GThread **workers = NULL;
+  GVariantBuilder builder;
+  guint64 size = 0;
+  gint sector_size = 0;
+  gint64 start;
+  gint64 end;
+  gint64 time_of_last_signal;
+  guint num_workers = 0;
+  gboolean ret = FALSE;
+  guint n;
+
+  if (data->queue_depth == 0 || data->queue_depth > BENCHMARK_MAX_QUEUE_DEPTH)
+    {
+      g_set_error (error, UDISKS_ERROR, UDISKS_ERROR_OPTION_NOT_PERMITTED,
+                   "Queue depth must be between 1 and %d", BENCHMARK_MAX_QUEUE_DEPTH);
+      return FALSE;
+    }
+  if (data->runtime == 0 || data->runtime > BENCHMARK_MAX_RUNTIME)
+    {
+      g_set_error (error, UDISKS_ERROR, UDISKS_ERROR_OPTION_NOT_PERMITTED,
+                   "Runtime must be between 1 and %d seconds", BENCHMARK_MAX_RUNTIME);
+      return FALSE;
+    }
+  /* every worker allocates and fills a buffer of this size */
+  if (data->block_size > BENCHMARK_MAX_BLOCK_SIZE)
+    {
+      g_set_error (error, UDISKS_ERROR, UDISKS_ERROR_OPTION_NOT_PERMITTED,
+                   "Block size must not exceed %d bytes", BENCHMARK_MAX_BLOCK_SIZE);
+      return FALSE;
+    }
+
+  state.data = data;
+  state.is_write = data->pattern == UDISKS_BENCHMARK_PATTERN_SEQ_WRITE ||
+                   data->pattern == UDISKS_BENCHMARK_PATTERN_RAND_WRITE;
+  state.is_random = data->pattern == UDISKS_BENCHMARK_PATTERN_RAND_READ ||
+                    data->pattern == UDISKS_BENCHMARK_PATTERN_RAND_WRITE;
+  stats_init (&state.stats);
+  g_mutex_init (&state.lock);
+
+  state.fd = open (data->device, (state.is_write ? O_WRONLY | O_EXCL : O_RDONLY) | O_DIRECT | O_CLOEXEC);
+  if (state.fd == -1)
+    {
+      g_set_error (error, UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                   "Error opening device %s for benchmark: %m", data->device);
+      goto out;
+    }
+
+  if (ioctl (state.fd, BLKGETSIZE64, &size) != 0 || ioctl (state.fd, BLKSSZGET, &sector_size) != 0)
+    {
+      g_set_error (error, UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                   "Error querying size of %s: %m", data->device);
+      goto out;
+    }
+
+  if (data->block_size == 0 || sector_size <= 0 || data->block_size % sector_size != 0)
+    {
+      g_set_error (error, UDISKS_ERROR, UDISKS_ERROR_OPTION_NOT_PERMITTED,
+                   "Block size must be a non-zero multiple of the logical sector size (%d bytes)",
+                   sector_size);
+      goto out;
+    }
+
+  if (data->region_size > 0)
+    size = MIN (size, data->region_size);
+  state.num_blocks = size / data->block_size;
+  if (state.num_blocks == 0)
+    {
+      g_set_error (error, UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                   "Device %s is smaller than the benchmark block size", data->device);
+      goto out;
+    }
+
+  udisks_job_set_progress_valid (UDISKS_JOB (job), TRUE);
+  udisks_job_set_expected_end_time (UDISKS_JOB (job),
+                                    g_get_real_time () + (gint64) data->runtime * G_USEC_PER_SEC);
+
+  start = g_get_monotonic_time ();
+  state.deadline = start + (gint64) data->runtime * G_USEC_PER_SEC;
+
+  workers = g_new0 (GThread *, data->queue_depth);
+  for (n = 0; n < data->queue_depth; n++)
+    {
+      GError *local_error = NULL;
+
+      workers[n] = g_thread_try_new ("benchmark-worker", benchmark_worker_func, &state, &local_error);
+      if (workers[n] == NULL)
+        {
+          benchmark_set_error (&state, local_error);
+          break;
+        }
+      num_workers++;
+    }
+
+  time_of_last_signal = start;
+  while (!g_atomic_int_get (&state.stop))
+    {
+      gint64 now;
+
+      g_usleep (G_USEC_PER_SEC / 10);
+
+      if (g_cancellable_is_cancelled (cancellable))
+        {
+          g_atomic_int_set (&state.stop, 1);
+          break;
+        }
+
+      now = g_get_monotonic_time ();
+      if (now >= state.deadline)
+        break;
+
+      /* only emit D-Bus signal at most once a second */
+      if (now - time_of_last_signal > G_USEC_PER_SEC)
+        {
+          guint64 bytes;
+
+          g_mutex_lock (&state.lock);
+          bytes = state.stats.bytes;
+          g_mutex_unlock (&state.lock);
+
+          udisks_job_set_progress (UDISKS_JOB (job), ((gdouble) (now - start)) / (state.deadline - start));
+          udisks_job_set_rate (UDISKS_JOB (job), bytes * G_USEC_PER_SEC / (now - start));
+          time_of_last_signal = now;
+        }
+    }
+
+  for (n = 0; n < num_workers; n++)
+    g_thread_join (workers[n]);
+  end = g_get_monotonic_time ();
+
+  if (g_cancellable_is_cancelled (cancellable))
+    {
+      g_set_error (error, UDISKS_ERROR, UDISKS_ERROR_CANCELLED,
+                   "Job was canceled");
+      goto out;
+    }
+
+  if (state.error != NULL)
+    {
+      g_propagate_error (error, state.error);
+      state.error = NULL;
+      goto out;
+    }
+
+  udisks_job_set_progress (UDISKS_JOB (job), 1.0);
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add (&builder, "{sv}", "runtime", g_variant_new_uint64 (end - start));
+  g_variant_builder_add (&builder, "{sv}", "ios", g_variant_new_uint64 (state.stats.ios));
+  g_variant_builder_add (&builder, "{sv}", "bytes", g_variant_new_uint64 (state.stats.bytes));
+  g_variant_builder_add (&builder, "{sv}", "iops",
+                         g_variant_new_double (((gdouble) state.stats.ios) * G_USEC_PER_SEC / (end - start)));
+  g_variant_builder_add (&builder, "{sv}", "throughput",
+                         g_variant_new_uint64 (state.stats.bytes * G_USEC_PER_SEC / (end - start)));
+  g_variant_builder_add (&builder, "{sv}", "latency-min",
+                         g_variant_new_uint64 (state.stats.ios > 0 ? state.stats.latency_min : 0));
+  g_variant_builder_add (&builder, "{sv}", "latency-max", g_variant_new_uint64 (state.stats.latency_max));
+  g_variant_builder_add (&builder, "{sv}", "latency-mean",
+                         g_variant_new_uint64 (state.stats.ios > 0 ? state.stats.latency_sum / state.stats.ios : 0));
+  g_variant_builder_add (&builder, "{sv}", "latency-p50", g_variant_new_uint64 (stats_get_percentile (&state.stats, 50.0)));
+  g_variant_builder_add (&builder, "{sv}", "latency-p90", g_variant_new_uint64 (stats_get_percentile (&state.stats, 90.0)));
+  g_variant_builder_add (&builder, "{sv}", "latency-p99", g_variant_new_uint64 (stats_get_percentile (&state.stats, 99.0)));
+  g_variant_builder_add (&builder, "{sv}", "latency-p99.9", g_variant_new_uint64 (stats_get_percentile (&state.stats, 99.9)));
+  data->results = g_variant_builder_end (&builder);
+
+  ret = TRUE;
+
+ out:
+  g_free (workers);
+  g_clear_error (&state.error);
+  g_mutex_clear (&state.lock);
+  if (state.fd != -1)
+    close (state.fd);
+  return ret;
+}
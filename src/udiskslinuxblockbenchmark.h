@@ -0,0 +1,78 @@
+/* -*- mode: C; c-file-style: "gnu"; indent-tabs-mode: nil; -*-
+ *
+ * Copyright (C) 2024 Red Hat, Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef __UDISKS_LINUX_BLOCK_BENCHMARK_H__
+#define __UDISKS_LINUX_BLOCK_BENCHMARK_H__
+
+#include "udisksdaemontypes.h"
+
+G_BEGIN_DECLS
+
+/**
+ * UDisksBenchmarkPattern:
+ * @UDISKS_BENCHMARK_PATTERN_SEQ_READ: Sequential reads.
+ * @UDISKS_BENCHMARK_PATTERN_SEQ_WRITE: Sequential writes.
+ * @UDISKS_BENCHMARK_PATTERN_RAND_READ: Random reads.
+ * @UDISKS_BENCHMARK_PATTERN_RAND_WRITE: Random writes.
+ *
+ * I/O patterns supported by the benchmark engine.
+ */
+typedef enum
+{
+  UDISKS_BENCHMARK_PATTERN_SEQ_READ,
+  UDISKS_BENCHMARK_PATTERN_SEQ_WRITE,
+  UDISKS_BENCHMARK_PATTERN_RAND_READ,
+  UDISKS_BENCHMARK_PATTERN_RAND_WRITE,
+} UDisksBenchmarkPattern;
+
+/**
+ * UDisksBenchmarkData:
+ * @device: The device file to benchmark.
+ * @pattern: The I/O pattern.
+ * @block_size: Size of each request in bytes.
+ * @queue_depth: Number of requests kept in flight.
+ * @runtime: Duration of the benchmark in seconds.
+ * @region_size: Number of bytes from the start of the device to use or 0 for the whole device.
+ * @results: Return location for the results, set on success.
+ *
+ * Parameters and results of a benchmark run, passed as user data to
+ * udisks_linux_block_benchmark_job_func().
+ */
+typedef struct
+{
+  const gchar            *device;
+  UDisksBenchmarkPattern  pattern;
+  guint64                 block_size;
+  guint                   queue_depth;
+  guint                   runtime;
+  guint64                 region_size;
+  GVariant               *results;
+} UDisksBenchmarkData;
+
+gboolean  udisks_linux_block_benchmark_parse_pattern (const gchar             *str,
+                                                      UDisksBenchmarkPattern  *out_pattern);
+gboolean  udisks_linux_block_benchmark_job_func      (UDisksThreadedJob       *job,
+                                                      GCancellable            *cancellable,
+                                                      gpointer                 user_data,
+                                                      GError                 **error);
+
+G_END_DECLS
+
+#endif /* __UDISKS_LINUX_BLOCK_BENCHMARK_H__ */
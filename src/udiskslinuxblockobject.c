@@ -33,6 +33,7 @@
 #include <sys/ioctl.h>
 #include <sys/file.h>
 #include <linux/fs.h>
+#include <linux/blkpg.h>
 
 #include <string.h>
 #include <stdlib.h>
@@ -88,6 +89,11 @@ struct _UDisksLinuxBlockObject
   UDisksLinuxDevice *device;
   GMutex device_mutex;
 
+  /* hash of the udev properties and sysfs attributes of @device the
+   * interfaces are computed from, see compute_fingerprint()
+   */
+  guint64 fingerprint;
+
   GMutex cleanup_mutex;
 
   /* interface */
@@ -122,6 +128,7 @@ static void on_mount_monitor_mount_added   (UDisksMountMonitor  *monitor,
 static void on_mount_monitor_mount_removed (UDisksMountMonitor  *monitor,
                                             UDisksMount         *mount,
                                             gpointer             user_data);
+static guint64 compute_fingerprint (UDisksLinuxDevice *device);
 
 static void
 udisks_linux_block_object_finalize (GObject *_object)
@@ -241,6 +248,7 @@ udisks_linux_block_object_constructed (GObject *_object)
                     object);
 
   /* initial coldplug */
+  object->fingerprint = compute_fingerprint (object->device);
   udisks_linux_block_object_uevent (object, "add", NULL);
 
   /* compute the object path */
@@ -878,6 +886,144 @@ nvme_namespace_update (UDisksObject   *object,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+static void
+update_module_ifaces (UDisksLinuxBlockObject *object,
+                      const gchar            *action,
+                      GList                  *modules)
+{
+  GList *l;
+
+  for (l = modules; l; l = g_list_next (l))
+    {
+      UDisksModule *module = l->data;
+      GType *types;
+
+      types = udisks_module_get_block_object_interface_types (module);
+      for (; types && *types; types++)
+        {
+          GDBusInterfaceSkeleton *interface;
+          gboolean keep = TRUE;
+
+          interface = g_hash_table_lookup (object->module_ifaces, GSIZE_TO_POINTER (*types));
+          if (interface != NULL)
+            {
+              /* ask the existing instance to process the uevent */
+              if (udisks_module_object_process_uevent (UDISKS_MODULE_OBJECT (interface),
+                                                       action, object->device, &keep))
+                {
+                  if (! keep)
+                    {
+                      g_dbus_object_skeleton_remove_interface (G_DBUS_OBJECT_SKELETON (object), interface);
+                      g_hash_table_remove (object->module_ifaces, GSIZE_TO_POINTER (*types));
+                    }
+                }
+            }
+          else
+            {
+              /* try create new interface and see if the module is interested in this object */
+              interface = udisks_module_new_block_object_interface (module, object, *types);
+              if (interface)
+                {
+                  /* do coldplug after creation */
+                  udisks_module_object_process_uevent (UDISKS_MODULE_OBJECT (interface), action, object->device, &keep);
+                  g_dbus_object_skeleton_add_interface (G_DBUS_OBJECT_SKELETON (object), interface);
+                  g_warn_if_fail (g_hash_table_replace (object->module_ifaces, GSIZE_TO_POINTER (*types), interface));
+                }
+            }
+        }
+    }
+}
+
+/* FNV-1a, each string is terminated so that "ab" + "c" differs from "a" + "bc" */
+static guint64
+fingerprint_add (guint64      hash,
+                 const gchar *str)
+{
+  const guchar *p;
+
+  if (str == NULL)
+    str = "";
+  for (p = (const guchar *) str; ; p++)
+    {
+      hash ^= *p;
+      hash *= G_GUINT64_CONSTANT (1099511628211);
+      if (*p == '\0')
+        break;
+    }
+  return hash;
+}
+
+static guint64
+fingerprint_add_dir (guint64      hash,
+                     const gchar *sysfs_path,
+                     const gchar *subdir,
+                     const gchar *prefix)
+{
+  gchar *path;
+  GDir *dir;
+  const gchar *name;
+
+  path = g_build_filename (sysfs_path, subdir, NULL);
+  dir = g_dir_open (path, 0, NULL);
+  if (dir != NULL)
+    {
+      while ((name = g_dir_read_name (dir)) != NULL)
+        if (prefix == NULL || g_str_has_prefix (name, prefix))
+          hash = fingerprint_add (hash, name);
+      g_dir_close (dir);
+    }
+  g_free (path);
+
+  /* terminate the list */
+  return fingerprint_add (hash, "/");
+}
+
+/* Computes a hash over everything the interfaces of a block object are
+ * derived from on a uevent: the udev properties (minus the per-event ones),
+ * the size and read-only flag, holders, slaves and partitions. Things that
+ * don't come with a uevent (mounts, fstab, crypttab) are handled separately
+ * and always cause a full update.
+ */
+static guint64
+compute_fingerprint (UDisksLinuxDevice *device)
+{
+  static const gchar *sysfs_attrs[] = { "size", "ro", "removable", "loop/backing_file", "loop/autoclear", NULL };
+  guint64 hash = G_GUINT64_CONSTANT (14695981039346656037);
+  const gchar *const *keys;
+  const gchar *sysfs_path;
+  guint n;
+
+  keys = g_udev_device_get_property_keys (device->udev_device);
+  for (n = 0; keys != NULL && keys[n] != NULL; n++)
+    {
+      if (g_strcmp0 (keys[n], "ACTION") == 0 ||
+          g_strcmp0 (keys[n], "SEQNUM") == 0 ||
+          g_str_has_prefix (keys[n], "SYNTH_"))
+        continue;
+      hash = fingerprint_add (hash, keys[n]);
+      hash = fingerprint_add (hash, g_udev_device_get_property (device->udev_device, keys[n]));
+    }
+
+  for (n = 0; sysfs_attrs[n] != NULL; n++)
+    hash = fingerprint_add (hash, g_udev_device_get_sysfs_attr (device->udev_device, sysfs_attrs[n]));
+
+  sysfs_path = g_udev_device_get_sysfs_path (device->udev_device);
+  hash = fingerprint_add_dir (hash, sysfs_path, "holders", NULL);
+  hash = fingerprint_add_dir (hash, sysfs_path, "slaves", NULL);
+  hash = fingerprint_add_dir (hash, sysfs_path, NULL, g_udev_device_get_name (device->udev_device));
+
+  return hash;
+}
+
+/* uevents triggered by the daemon itself are expected to refresh the object */
+static gboolean
+is_own_uevent (UDisksLinuxBlockObject *object,
+               UDisksLinuxDevice      *device)
+{
+  return g_strcmp0 (g_udev_device_get_property (device->udev_device, "SYNTH_UUID"),
+                    udisks_daemon_get_uuid (object->daemon)) == 0;
+}
+
 /**
  * udisks_linux_block_object_uevent:
  * @object: A #UDisksLinuxBlockObject.
@@ -885,6 +1031,10 @@ nvme_namespace_update (UDisksObject   *object,
  * @device: A new #UDisksLinuxDevice device object or %NULL if the device hasn't changed.
  *
  * Updates all information on interfaces on @object as a result of incoming uevent processing.
+ *
+ * A "change" uevent for a @device that looks the same as the previous one
+ * (e.g. one triggered by the udev watch after a close-write) doesn't update
+ * any interface, unless the uevent has been triggered by the daemon itself.
  */
 void
 udisks_linux_block_object_uevent (UDisksLinuxBlockObject *object,
@@ -893,13 +1043,21 @@ udisks_linux_block_object_uevent (UDisksLinuxBlockObject *object,
 {
   UDisksModuleManager *module_manager;
   GList *modules;
-  GList *l;
+  gboolean unchanged = FALSE;
 
   g_return_if_fail (UDISKS_IS_LINUX_BLOCK_OBJECT (object));
   g_return_if_fail (device == NULL || UDISKS_IS_LINUX_DEVICE (device));
 
   if (device != NULL)
     {
+      guint64 fingerprint;
+
+      fingerprint = compute_fingerprint (device);
+      unchanged = g_strcmp0 (action, "change") == 0 &&
+                  fingerprint == object->fingerprint &&
+                  !is_own_uevent (object, device);
+      object->fingerprint = fingerprint;
+
       g_mutex_lock (&object->device_mutex);
       g_object_unref (object->device);
       object->device = g_object_ref (device);
@@ -907,6 +1065,13 @@ udisks_linux_block_object_uevent (UDisksLinuxBlockObject *object,
       g_object_notify (G_OBJECT (object), "device");
     }
 
+  if (unchanged)
+    {
+      udisks_debug ("Skipping update of %s, nothing has changed",
+                    g_dbus_object_get_object_path (G_DBUS_OBJECT (object)));
+      return;
+    }
+
   update_iface (UDISKS_OBJECT (object), action, block_device_check, block_device_connect, block_device_update,
                 UDISKS_TYPE_LINUX_BLOCK, &object->iface_block_device);
   g_warn_if_fail (object->iface_block_device != NULL);
@@ -928,46 +1093,25 @@ udisks_linux_block_object_uevent (UDisksLinuxBlockObject *object,
   /* Attach interfaces from modules */
   module_manager = udisks_daemon_get_module_manager (object->daemon);
   modules = udisks_module_manager_get_modules (module_manager);
-  for (l = modules; l; l = g_list_next (l))
-    {
-      UDisksModule *module = l->data;
-      GType *types;
+  update_module_ifaces (object, action, modules);
+  g_list_free_full (modules, g_object_unref);
+}
 
-      types = udisks_module_get_block_object_interface_types (module);
-      for (; types && *types; types++)
-        {
-          GDBusInterfaceSkeleton *interface;
-          gboolean keep = TRUE;
+/**
+ * udisks_linux_block_object_coldplug_modules:
+ * @object: A #UDisksLinuxBlockObject.
+ * @modules: (element-type UDisksModule): Newly activated modules.
+ *
+ * Attaches interfaces from @modules to @object without updating any
+ * other interfaces.
+ */
+void
+udisks_linux_block_object_coldplug_modules (UDisksLinuxBlockObject *object,
+                                            GList                  *modules)
+{
+  g_return_if_fail (UDISKS_IS_LINUX_BLOCK_OBJECT (object));
 
-          interface = g_hash_table_lookup (object->module_ifaces, GSIZE_TO_POINTER (*types));
-          if (interface != NULL)
-            {
-              /* ask the existing instance to process the uevent */
-              if (udisks_module_object_process_uevent (UDISKS_MODULE_OBJECT (interface),
-                                                       action, object->device, &keep))
-                {
-                  if (! keep)
-                    {
-                      g_dbus_object_skeleton_remove_interface (G_DBUS_OBJECT_SKELETON (object), interface);
-                      g_hash_table_remove (object->module_ifaces, GSIZE_TO_POINTER (*types));
-                    }
-                }
-            }
-          else
-            {
-              /* try create new interface and see if the module is interested in this object */
-              interface = udisks_module_new_block_object_interface (module, object, *types);
-              if (interface)
-                {
-                  /* do coldplug after creation */
-                  udisks_module_object_process_uevent (UDISKS_MODULE_OBJECT (interface), action, object->device, &keep);
-                  g_dbus_object_skeleton_add_interface (G_DBUS_OBJECT_SKELETON (object), interface);
-                  g_warn_if_fail (g_hash_table_replace (object->module_ifaces, GSIZE_TO_POINTER (*types), interface));
-                }
-            }
-        }
-    }
-  g_list_free_full (modules, g_object_unref);
+  update_module_ifaces (object, "add", modules);
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
@@ -1133,6 +1277,116 @@ udisks_linux_block_object_reread_partition_table (UDisksLinuxBlockObject  *objec
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+static gboolean
+update_partition_blkpg (UDisksLinuxBlockObject  *object,
+                        gint                     op,
+                        gint                     number,
+                        guint64                  offset,
+                        guint64                  size,
+                        GError                 **error)
+{
+  UDisksLinuxDevice *device;
+  const gchar *device_file;
+  struct blkpg_ioctl_arg ioctl_arg;
+  struct blkpg_partition part;
+  gint num_tries;
+  gint fd;
+  gboolean ret = TRUE;
+
+  device = udisks_linux_block_object_get_device (object);
+  device_file = g_udev_device_get_device_file (device->udev_device);
+  fd = open (device_file, O_RDONLY);
+  if (fd == -1)
+    {
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   "Error opening %s while updating partition %d: %m", device_file, number);
+      g_object_unref (device);
+      return FALSE;
+    }
+
+  memset (&part, 0, sizeof (part));
+  part.pno = number;
+  part.start = (long long) offset;
+  part.length = (long long) size;
+
+  memset (&ioctl_arg, 0, sizeof (ioctl_arg));
+  ioctl_arg.op = op;
+  ioctl_arg.datalen = sizeof (part);
+  ioctl_arg.data = &part;
+
+  num_tries = 5;
+  while (ioctl (fd, BLKPG, &ioctl_arg) != 0)
+    {
+      if (errno == EBUSY && num_tries-- >= 0)
+        {
+          g_usleep (200 * 1000); /* microseconds */
+          continue;
+        }
+      /* the partition is already gone, nothing to do */
+      if (errno == ENXIO && op == BLKPG_DEL_PARTITION)
+        break;
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   "Error updating partition %d (BLKPG ioctl) on %s: %m", number, device_file);
+      ret = FALSE;
+      break;
+    }
+  close (fd);
+
+  g_object_unref (device);
+  return ret;
+}
+
+/**
+ * udisks_linux_block_object_delete_partition:
+ * @object: A #UDisksLinuxBlockObject for a partitioned block device.
+ * @number: The partition number.
+ * @error: Return location for error.
+ *
+ * Removes partition @number from the kernel view of @object using the
+ * BLKPG ioctl. A partition that is already gone is not an error.
+ *
+ * Returns: %TRUE if the request succeeded or %FALSE with @error set.
+ */
+gboolean
+udisks_linux_block_object_delete_partition (UDisksLinuxBlockObject  *object,
+                                            gint                     number,
+                                            GError                 **error)
+{
+  g_return_val_if_fail (UDISKS_IS_LINUX_BLOCK_OBJECT (object), FALSE);
+  g_warn_if_fail (!error || !*error);
+
+  return update_partition_blkpg (object, BLKPG_DEL_PARTITION, number, 0, 0, error);
+}
+
+/**
+ * udisks_linux_block_object_resize_partition:
+ * @object: A #UDisksLinuxBlockObject for a partitioned block device.
+ * @number: The partition number.
+ * @offset: The partition start in bytes.
+ * @size: The new partition size in bytes.
+ * @error: Return location for error.
+ *
+ * Updates the size of partition @number in the kernel view of @object
+ * using the BLKPG ioctl. The start of the partition cannot be changed
+ * this way.
+ *
+ * Returns: %TRUE if the request succeeded or %FALSE with @error set.
+ */
+gboolean
+udisks_linux_block_object_resize_partition (UDisksLinuxBlockObject  *object,
+                                            gint                     number,
+                                            guint64                  offset,
+                                            guint64                  size,
+                                            GError                 **error)
+{
+  g_return_val_if_fail (UDISKS_IS_LINUX_BLOCK_OBJECT (object), FALSE);
+  g_warn_if_fail (!error || !*error);
+
+  return update_partition_blkpg (object, BLKPG_RESIZE_PARTITION, number, offset, size, error);
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
 /**
  * udisks_linux_block_object_try_lock_for_cleanup:
  * @object: A #UDisksLinuxBlockObject.
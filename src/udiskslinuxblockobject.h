@@ -36,6 +36,8 @@ UDisksLinuxBlockObject   *udisks_linux_block_object_new        (UDisksDaemon
 void                      udisks_linux_block_object_uevent     (UDisksLinuxBlockObject  *object,
                                                                 const gchar             *action,
                                                                 UDisksLinuxDevice       *device);
+void                      udisks_linux_block_object_coldplug_modules (UDisksLinuxBlockObject *object,
+                                                                      GList                  *modules);
 UDisksDaemon             *udisks_linux_block_object_get_daemon (UDisksLinuxBlockObject  *object);
 UDisksLinuxDevice        *udisks_linux_block_object_get_device (UDisksLinuxBlockObject  *object);
 gchar                    *udisks_linux_block_object_get_device_file (UDisksLinuxBlockObject *object);
@@ -46,6 +48,14 @@ gboolean                  udisks_linux_block_object_trigger_uevent_sync (UDisksL
                                                                          guint                   timeout_seconds);
 gboolean                  udisks_linux_block_object_reread_partition_table (UDisksLinuxBlockObject  *object,
                                                                             GError                 **error);
+gboolean                  udisks_linux_block_object_delete_partition (UDisksLinuxBlockObject  *object,
+                                                                      gint                     number,
+                                                                      GError                 **error);
+gboolean                  udisks_linux_block_object_resize_partition (UDisksLinuxBlockObject  *object,
+                                                                      gint                     number,
+                                                                      guint64                  offset,
+                                                                      guint64                  size,
+                                                                      GError                 **error);
 gboolean                  udisks_linux_block_object_contains_filesystem (UDisksObject *object);
 
 void                      udisks_linux_block_object_lock_for_cleanup     (UDisksLinuxBlockObject *object);
@@ -31,6 +31,7 @@
 
 #include <sys/ioctl.h>
 #include <fcntl.h>
+#include <unistd.h>
 #include <linux/cdrom.h>
 
 #include <glib.h>
@@ -131,8 +132,8 @@ udisks_linux_device_new_sync (GUdevDevice *udev_device, GUdevClient *udev_client
  out:
   if (error != NULL)
     {
-      udisks_warning ("Error probing device: %s (%s, %d)",
-                      error->message, g_quark_to_string (error->domain), error->code);
+      udisks_warning_ratelimited ("Error probing device: %s (%s, %d)",
+                                  error->message, g_quark_to_string (error->domain), error->code);
       g_clear_error (&error);
     }
 
@@ -360,6 +361,58 @@ probe_ata (UDisksLinuxDevice  *device,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+/* sysfs attributes are at most a page long */
+#define SYSFS_ATTR_MAX_SIZE 4096
+
+/* Reads the whole attribute from offset 0 into @buf, NUL-terminated and
+ * with trailing whitespace removed. Sets a #GFileError on failure.
+ */
+static gboolean
+read_sysfs_fd (gint          fd,
+               const gchar  *path,
+               gchar        *buf,
+               gsize         buf_size,
+               GError      **error)
+{
+  gsize len = 0;
+  gssize num_read;
+
+  g_return_val_if_fail (buf_size > 0, FALSE);
+
+  while (len < buf_size - 1)
+    {
+      num_read = pread (fd, buf + len, buf_size - 1 - len, len);
+      if (num_read < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno),
+                       "Error reading %s: %m", path);
+          return FALSE;
+        }
+      if (num_read == 0)
+        break;
+      len += num_read;
+    }
+  buf[len] = '\0';
+  g_strchomp (buf);
+
+  return TRUE;
+}
+
+static gint
+open_sysfs_attr (const gchar  *path,
+                 GError      **error)
+{
+  gint fd;
+
+  fd = open (path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno),
+                 "Error opening %s: %m", path);
+  return fd;
+}
+
 /**
  * udisks_linux_device_read_sysfs_attr:
  * @device: A #UDisksLinuxDevice.
@@ -384,15 +437,20 @@ udisks_linux_device_read_sysfs_attr (UDisksLinuxDevice  *device,
   g_return_val_if_fail (attr != NULL, NULL);
 
   path = g_strdup_printf ("%s/%s", g_udev_device_get_sysfs_path (device->udev_device), attr);
-  if (!g_file_get_contents (path, &ret, NULL /* size */, error))
-    {
-      g_prefix_error (error, "Error reading sysfs attr `%s': ", path);
-    }
-  else
-    {
-      /* remove newline from the attribute */
-      g_strstrip (ret);
-    }
+  {
+    gchar buf[SYSFS_ATTR_MAX_SIZE + 1];
+    gint fd;
+
+    fd = open_sysfs_attr (path, error);
+    if (fd != -1)
+      {
+        if (read_sysfs_fd (fd, path, buf, sizeof (buf), error))
+          ret = g_strdup (g_strchug (buf));
+        close (fd);
+      }
+  }
+  if (ret == NULL)
+    g_prefix_error (error, "Error reading sysfs attr `%s': ", path);
   g_free (path);
 
   return ret;
@@ -452,6 +510,120 @@ udisks_linux_device_read_sysfs_attr_as_uint64 (UDisksLinuxDevice  *device,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+struct _UDisksLinuxSysfsAttr
+{
+  gchar *path;
+  GMutex lock;
+  gint fd;
+};
+
+/**
+ * udisks_linux_sysfs_attr_new:
+ * @path: Full path to a sysfs attribute.
+ *
+ * Creates an accessor for the sysfs attribute at @path. The attribute is
+ * opened on first read and kept open, subsequent reads only cost a
+ * pread() call. This is meant for attributes that are sampled
+ * periodically, e.g. the block device <filename>stat</filename> file.
+ *
+ * Returns: (transfer full): A #UDisksLinuxSysfsAttr. Free with udisks_linux_sysfs_attr_free().
+ */
+UDisksLinuxSysfsAttr *
+udisks_linux_sysfs_attr_new (const gchar *path)
+{
+  UDisksLinuxSysfsAttr *attr;
+
+  g_return_val_if_fail (path != NULL, NULL);
+
+  attr = g_new0 (UDisksLinuxSysfsAttr, 1);
+  attr->path = g_strdup (path);
+  attr->fd = -1;
+  g_mutex_init (&attr->lock);
+
+  return attr;
+}
+
+/**
+ * udisks_linux_sysfs_attr_free:
+ * @attr: (nullable): A #UDisksLinuxSysfsAttr.
+ *
+ * Closes and frees @attr.
+ */
+void
+udisks_linux_sysfs_attr_free (UDisksLinuxSysfsAttr *attr)
+{
+  if (attr == NULL)
+    return;
+
+  if (attr->fd != -1)
+    close (attr->fd);
+  g_mutex_clear (&attr->lock);
+  g_free (attr->path);
+  g_free (attr);
+}
+
+/**
+ * udisks_linux_sysfs_attr_get_path:
+ * @attr: A #UDisksLinuxSysfsAttr.
+ *
+ * Gets the path of the attribute.
+ *
+ * Returns: The path. Do not free, the string is owned by @attr.
+ */
+const gchar *
+udisks_linux_sysfs_attr_get_path (UDisksLinuxSysfsAttr *attr)
+{
+  g_return_val_if_fail (attr != NULL, NULL);
+  return attr->path;
+}
+
+/**
+ * udisks_linux_sysfs_attr_read:
+ * @attr: A #UDisksLinuxSysfsAttr.
+ * @buf: Buffer to read the attribute into, typically on the stack.
+ * @buf_size: Size of @buf. Longer contents are truncated.
+ * @error: Return location for error or %NULL.
+ *
+ * Reads the current contents of @attr into @buf. The result is
+ * NUL-terminated and has any trailing newline removed. Can be called
+ * from multiple threads. If the read fails, the attribute is reopened
+ * on the next call.
+ *
+ * Returns: %TRUE on success, %FALSE if @error is set.
+ */
+gboolean
+udisks_linux_sysfs_attr_read (UDisksLinuxSysfsAttr  *attr,
+                              gchar                 *buf,
+                              gsize                  buf_size,
+                              GError               **error)
+{
+  gboolean ret = FALSE;
+
+  g_return_val_if_fail (attr != NULL, FALSE);
+  g_return_val_if_fail (buf != NULL && buf_size > 0, FALSE);
+
+  g_mutex_lock (&attr->lock);
+  if (attr->fd == -1)
+    {
+      attr->fd = open_sysfs_attr (attr->path, error);
+      if (attr->fd == -1)
+        goto out;
+    }
+
+  ret = read_sysfs_fd (attr->fd, attr->path, buf, buf_size, error);
+  if (!ret)
+    {
+      close (attr->fd);
+      attr->fd = -1;
+    }
+
+ out:
+  g_mutex_unlock (&attr->lock);
+  return ret;
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
 /**
  * udisks_linux_device_subsystem_is_nvme:
  * @device: A #UDisksLinuxDevice.
@@ -74,6 +74,21 @@ guint64            udisks_linux_device_read_sysfs_attr_as_uint64 (UDisksLinuxDev
                                                                   const gchar        *attr,
                                                                   GError            **error);
 
+/**
+ * UDisksLinuxSysfsAttr:
+ *
+ * A sysfs attribute kept open for repeated reads, see udisks_linux_sysfs_attr_new().
+ */
+typedef struct _UDisksLinuxSysfsAttr UDisksLinuxSysfsAttr;
+
+UDisksLinuxSysfsAttr *udisks_linux_sysfs_attr_new      (const gchar           *path);
+void                  udisks_linux_sysfs_attr_free     (UDisksLinuxSysfsAttr  *attr);
+const gchar          *udisks_linux_sysfs_attr_get_path (UDisksLinuxSysfsAttr  *attr);
+gboolean              udisks_linux_sysfs_attr_read     (UDisksLinuxSysfsAttr  *attr,
+                                                        gchar                 *buf,
+                                                        gsize                  buf_size,
+                                                        GError               **error);
+
 gboolean           udisks_linux_device_subsystem_is_nvme         (UDisksLinuxDevice  *device);
 gboolean           udisks_linux_device_nvme_is_fabrics           (UDisksLinuxDevice  *device);
 
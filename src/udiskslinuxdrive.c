@@ -1046,7 +1046,7 @@ udisks_linux_drive_update (UDisksLinuxDrive       *drive,
   ret = update_configuration (drive, object);
 
  out:
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (drive));
+  udisks_daemon_util_flush_interface (drive);
   if (device != NULL)
     g_clear_object (&device);
 
@@ -1055,6 +1055,47 @@ udisks_linux_drive_update (UDisksLinuxDrive       *drive,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+typedef struct
+{
+  UDisksDrive *drive;
+  GDBusMethodInvocation *invocation;
+  gchar *device;
+} EjectData;
+
+static void
+eject_data_free (EjectData *data)
+{
+  g_object_unref (data->drive);
+  g_free (data->device);
+  g_free (data);
+}
+
+static void
+eject_cb (GObject      *source_object,
+          GAsyncResult *result,
+          gpointer      user_data)
+{
+  EjectData *data = user_data;
+  GError *error = NULL;
+
+  if (!udisks_daemon_run_job_finish (UDISKS_DAEMON (source_object), result, NULL, &error))
+    {
+      g_dbus_method_invocation_return_error (data->invocation,
+                                             UDISKS_ERROR,
+                                             UDISKS_ERROR_FAILED,
+                                             "Error ejecting %s: %s",
+                                             data->device,
+                                             error->message);
+      g_clear_error (&error);
+    }
+  else
+    {
+      udisks_drive_complete_eject (data->drive, data->invocation);
+    }
+
+  eject_data_free (data);
+}
+
 static gboolean
 handle_eject (UDisksDrive           *_drive,
               GDBusMethodInvocation *invocation,
@@ -1067,9 +1108,10 @@ handle_eject (UDisksDrive           *_drive,
   UDisksDaemon *daemon = NULL;
   const gchar *action_id;
   const gchar *message;
-  gchar *error_message = NULL;
+  const gchar *argv[3];
+  UDisksBaseJob *job;
+  EjectData *data;
   GError *error = NULL;
-  gchar *escaped_device = NULL;
   uid_t caller_uid;
 
   object = udisks_daemon_util_dup_object (drive, &error);
@@ -1137,35 +1179,27 @@ handle_eject (UDisksDrive           *_drive,
                                                     invocation))
     goto out;
 
-  escaped_device = g_shell_quote (udisks_block_get_device (block));
-
-  if (!udisks_daemon_launch_spawned_job_sync (daemon,
-                                              UDISKS_OBJECT (object),
-                                              "drive-eject", caller_uid,
-                                              NULL, /* GCancellable */
-                                              0,    /* uid_t run_as_uid */
-                                              0,    /* uid_t run_as_euid */
-                                              NULL, /* gint *out_status */
-                                              &error_message,
-                                              NULL,  /* input_string */
-                                              "eject %s",
-                                              escaped_device))
-    {
-      g_dbus_method_invocation_return_error (invocation,
-                                             UDISKS_ERROR,
-                                             UDISKS_ERROR_FAILED,
-                                             "Error ejecting %s: %s",
-                                             udisks_block_get_device (block),
-                                             error_message);
-      goto out;
-    }
-
-  udisks_drive_complete_eject (UDISKS_DRIVE (drive), invocation);
+  /* don't block the handler thread while the program runs */
+  argv[0] = "eject";
+  argv[1] = udisks_block_get_device (block);
+  argv[2] = NULL;
+  job = udisks_daemon_launch_spawned_job_argv (daemon,
+                                               UDISKS_OBJECT (object),
+                                               "drive-eject", caller_uid,
+                                               NULL, /* GCancellable */
+                                               0,    /* uid_t run_as_uid */
+                                               0,    /* uid_t run_as_euid */
+                                               NULL, /* input_string */
+                                               argv);
+
+  data = g_new0 (EjectData, 1);
+  data->drive = g_object_ref (_drive);
+  data->invocation = invocation;
+  data->device = g_strdup (udisks_block_get_device (block));
+  udisks_daemon_run_job (daemon, job, NULL, eject_cb, data);
 
  out:
-  g_free (escaped_device);
   g_clear_object (&block_object);
-  g_free (error_message);
   g_clear_object (&object);
   return TRUE; /* returning TRUE means that we handled the method invocation */
 }
@@ -83,8 +83,19 @@ struct _UDisksLinuxDriveAta
   gboolean     secure_erase_in_progress;
   unsigned long drive_read, drive_write;
   gboolean     standby_enabled;
+  UDisksLinuxSysfsAttr *stat_attr;
+
+  /* PM state cache, see get_pm_state_cached() */
+  GMutex       pm_mutex;
+  gchar       *pm_device_file;
+  gint         pm_fd;
+  guchar       pm_state;
+  gint64       pm_state_updated;
 };
 
+/* How long a PM state read from the drive is considered current */
+#define PM_STATE_CACHE_TTL_USEC (2 * G_USEC_PER_SEC)
+
 struct _UDisksLinuxDriveAtaClass
 {
   UDisksDriveAtaSkeletonClass parent_class;
@@ -103,6 +114,12 @@ udisks_linux_drive_ata_finalize (GObject *object)
   UDisksLinuxDriveAta *drive = UDISKS_LINUX_DRIVE_ATA (object);
 
   bd_smart_ata_free (drive->smart_data);
+  udisks_linux_sysfs_attr_free (drive->stat_attr);
+
+  if (drive->pm_fd != -1)
+    close (drive->pm_fd);
+  g_free (drive->pm_device_file);
+  g_mutex_clear (&drive->pm_mutex);
 
   if (G_OBJECT_CLASS (udisks_linux_drive_ata_parent_class)->finalize != NULL)
     G_OBJECT_CLASS (udisks_linux_drive_ata_parent_class)->finalize (object);
@@ -111,6 +128,9 @@ udisks_linux_drive_ata_finalize (GObject *object)
 static void
 udisks_linux_drive_ata_init (UDisksLinuxDriveAta *drive)
 {
+  g_mutex_init (&drive->pm_mutex);
+  drive->pm_fd = -1;
+
   g_dbus_interface_skeleton_set_flags (G_DBUS_INTERFACE_SKELETON (drive),
                                        G_DBUS_INTERFACE_SKELETON_FLAGS_HANDLE_METHOD_INVOCATIONS_IN_THREAD);
 }
@@ -420,9 +440,21 @@ udisks_linux_drive_ata_update (UDisksLinuxDriveAta    *drive,
   update_pm (drive, device);
   update_security (drive, device);
 
+  g_mutex_lock (&drive->pm_mutex);
+  if (g_strcmp0 (drive->pm_device_file, g_udev_device_get_device_file (device->udev_device)) != 0)
+    {
+      if (drive->pm_fd != -1)
+        close (drive->pm_fd);
+      drive->pm_fd = -1;
+      drive->pm_state_updated = 0;
+      g_free (drive->pm_device_file);
+      drive->pm_device_file = g_strdup (g_udev_device_get_device_file (device->udev_device));
+    }
+  g_mutex_unlock (&drive->pm_mutex);
+
  out:
   /* ensure property changes are sent before the method return */
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (drive));
+  udisks_daemon_util_flush_interface (drive);
   if (device != NULL)
     g_object_unref (device);
 
@@ -431,35 +463,135 @@ udisks_linux_drive_ata_update (UDisksLinuxDriveAta    *drive,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+/* Returns the PM state of @drive, sending CHECK POWER MODE only if the last
+ * one is older than PM_STATE_CACHE_TTL_USEC. The device is kept open without
+ * doing any I/O so that polling neither reopens it nor wakes it up.
+ *
+ * The ioctl may block for a long time on some drives, so it is sent on a
+ * duplicate of the cached fd without holding pm_mutex, which is also taken
+ * on uevents and from property getters.
+ */
+static gboolean
+get_pm_state_cached (UDisksLinuxDriveAta  *drive,
+                     GError              **error,
+                     guchar               *pm_state)
+{
+  gboolean ret = FALSE;
+  gchar *device_file = NULL;
+  gint fd = -1;
+  gint64 now;
+
+  g_mutex_lock (&drive->pm_mutex);
+  now = g_get_monotonic_time ();
+  if (drive->pm_state_updated > 0 && now - drive->pm_state_updated < PM_STATE_CACHE_TTL_USEC)
+    {
+      *pm_state = drive->pm_state;
+      g_mutex_unlock (&drive->pm_mutex);
+      return TRUE;
+    }
+  device_file = g_strdup (drive->pm_device_file);
+  if (drive->pm_fd != -1)
+    fd = fcntl (drive->pm_fd, F_DUPFD_CLOEXEC, 0);
+  g_mutex_unlock (&drive->pm_mutex);
+
+  if (device_file == NULL)
+    {
+      g_set_error_literal (error, UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                           "No udev device");
+      goto out;
+    }
+
+  if (fd == -1)
+    {
+      fd = open (device_file, O_RDONLY|O_NONBLOCK|O_CLOEXEC);
+      if (fd == -1)
+        {
+          g_set_error (error, UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                       "Error opening device file %s while getting PM state: %m",
+                       device_file);
+          goto out;
+        }
+    }
+
+  ret = udisks_ata_get_pm_state_fd (fd, error, pm_state);
+
+  g_mutex_lock (&drive->pm_mutex);
+  /* the device may have changed or gone away in the meantime */
+  if (g_strcmp0 (drive->pm_device_file, device_file) == 0)
+    {
+      if (ret)
+        {
+          drive->pm_state = *pm_state;
+          drive->pm_state_updated = now;
+          if (drive->pm_fd == -1)
+            {
+              drive->pm_fd = fd;
+              fd = -1;
+            }
+        }
+      else if (drive->pm_fd != -1)
+        {
+          /* the device node may be stale, reopen it next time */
+          close (drive->pm_fd);
+          drive->pm_fd = -1;
+        }
+    }
+  g_mutex_unlock (&drive->pm_mutex);
+
+ out:
+  if (fd != -1)
+    close (fd);
+  g_free (device_file);
+  return ret;
+}
+
+static void
+invalidate_pm_state (UDisksLinuxDriveAta *drive)
+{
+  g_mutex_lock (&drive->pm_mutex);
+  drive->pm_state_updated = 0;
+  g_mutex_unlock (&drive->pm_mutex);
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
 static gboolean update_io_stats (UDisksLinuxDriveAta *drive, UDisksLinuxDevice *device)
 {
-  const gchar *drivepath = g_udev_device_get_sysfs_path (device->udev_device);
   gchar statpath[PATH_MAX];
+  gchar buf[256];
   unsigned long drive_read, drive_write;
-  FILE *statf;
+  GError *error = NULL;
   gboolean noio = FALSE;
-  snprintf (statpath, sizeof(statpath), "%s/stat", drivepath);
-  statf = fopen (statpath, "r");
-  if (statf == NULL)
+
+  snprintf (statpath, sizeof(statpath), "%s/stat", g_udev_device_get_sysfs_path (device->udev_device));
+
+  G_LOCK (object_lock);
+  /* keep the stat file open for the lifetime of the drive, reopen if the path changes */
+  if (drive->stat_attr == NULL || g_strcmp0 (udisks_linux_sysfs_attr_get_path (drive->stat_attr), statpath) != 0)
     {
-      udisks_warning ("Failed to open %s\n", statpath);
+      udisks_linux_sysfs_attr_free (drive->stat_attr);
+      drive->stat_attr = udisks_linux_sysfs_attr_new (statpath);
+    }
+
+  if (!udisks_linux_sysfs_attr_read (drive->stat_attr, buf, sizeof (buf), &error))
+    {
+      udisks_warning_ratelimited ("Failed to read %s: %s", statpath, error->message);
+      g_clear_error (&error);
+    }
+  else if (sscanf (buf, "%lu %*u %*u %*u %lu", &drive_read, &drive_write) != 2)
+    {
+      udisks_warning_ratelimited ("Failed to parse %s", statpath);
     }
   else
     {
-      if (fscanf (statf, "%lu %*u %*u %*u %lu", &drive_read, &drive_write) != 2)
-        {
-          udisks_warning ("Failed to read %s\n", statpath);
-        }
-      else
-        {
-          noio = drive_read == drive->drive_read && drive_write == drive->drive_write;
-          udisks_debug ("drive_read=%lu, drive_write=%lu, old_drive_read=%lu, old_drive_write=%lu\n",
-                        drive_read, drive_write, drive->drive_read, drive->drive_write);
-          drive->drive_read = drive_read;
-          drive->drive_write = drive_write;
-        }
-      fclose (statf);
+      noio = drive_read == drive->drive_read && drive_write == drive->drive_write;
+      udisks_debug ("drive_read=%lu, drive_write=%lu, old_drive_read=%lu, old_drive_write=%lu\n",
+                    drive_read, drive_write, drive->drive_read, drive->drive_write);
+      drive->drive_read = drive_read;
+      drive->drive_write = drive_write;
     }
+  G_UNLOCK (object_lock);
+
   return noio;
 }
 
@@ -574,7 +706,7 @@ udisks_linux_drive_ata_refresh_smart_sync (UDisksLinuxDriveAta  *drive,
 
       if (drive->standby_enabled)
         noio = update_io_stats (drive, device);
-      if (!udisks_ata_get_pm_state (g_udev_device_get_device_file (device->udev_device), error, &count))
+      if (!get_pm_state_cached (drive, error, &count))
         goto out;
       awake = count == 0xFF || count == 0x80;
       /* don't wake up disk unless specically asked to */
@@ -1429,7 +1561,6 @@ udisks_linux_drive_ata_get_pm_state (UDisksLinuxDriveAta  *drive,
                                      guchar               *pm_state)
 {
   UDisksLinuxDriveObject *object;
-  UDisksLinuxDevice *device = NULL;
   gboolean ret = FALSE;
 
   object = udisks_daemon_util_dup_object (drive, error);
@@ -1456,23 +1587,62 @@ udisks_linux_drive_ata_get_pm_state (UDisksLinuxDriveAta  *drive,
 
   /* TODO: some SSD controllers may block for considerable time when trimming large amount of blocks */
 
-  device = udisks_linux_drive_object_get_device (object, FALSE /* get_hw */);
-  if (device == NULL)
-    {
-      g_set_error_literal (error, UDISKS_ERROR, UDISKS_ERROR_FAILED,
-                           "No udev device");
-      goto out;
-    }
-
-  ret = udisks_ata_get_pm_state (g_udev_device_get_device_file (device->udev_device), error, pm_state);
+  ret = get_pm_state_cached (drive, error, pm_state);
 
  out:
-  g_clear_object (&device);
   g_clear_object (&object);
 
   return ret;
 }
 
+/**
+ * udisks_linux_drive_ata_release_device:
+ * @drive: A #UDisksLinuxDriveAta.
+ *
+ * Closes the device file kept open for querying the PM state. Called
+ * when a device of the drive goes away so that the kernel can release
+ * it even while @drive is still referenced. The device is opened again
+ * on the next PM state query.
+ */
+void
+udisks_linux_drive_ata_release_device (UDisksLinuxDriveAta *drive)
+{
+  g_return_if_fail (UDISKS_IS_LINUX_DRIVE_ATA (drive));
+
+  g_mutex_lock (&drive->pm_mutex);
+  if (drive->pm_fd != -1)
+    close (drive->pm_fd);
+  drive->pm_fd = -1;
+  drive->pm_state_updated = 0;
+  g_clear_pointer (&drive->pm_device_file, g_free);
+  g_mutex_unlock (&drive->pm_mutex);
+}
+
+/**
+ * udisks_linux_drive_ata_get_pm_state_cached:
+ * @drive: A #UDisksLinuxDriveAta.
+ * @error: Return location for error.
+ * @pm_state: Return location for the current power state value.
+ *
+ * Like udisks_linux_drive_ata_get_pm_state() but doesn't look up the drive
+ * object nor check whether PM is supported and enabled. Safe to call with
+ * the object manager lock held.
+ *
+ * The state is shared by all callers and refreshed at most every couple of
+ * seconds, querying it never wakes up the drive.
+ *
+ * Returns: %TRUE if the operation succeeded, %FALSE if @error is set.
+ */
+gboolean
+udisks_linux_drive_ata_get_pm_state_cached (UDisksLinuxDriveAta  *drive,
+                                            GError              **error,
+                                            guchar               *pm_state)
+{
+  g_return_val_if_fail (UDISKS_IS_LINUX_DRIVE_ATA (drive), FALSE);
+
+  return get_pm_state_cached (drive, error, pm_state);
+}
+
 static gboolean
 handle_pm_get_state (UDisksDriveAta        *_drive,
                      GDBusMethodInvocation *invocation,
@@ -1667,6 +1837,7 @@ handle_pm_standby_wakeup (UDisksDriveAta        *_drive,
  out:
   if (fd != -1)
     close (fd);
+  invalidate_pm_state (drive);
   g_clear_object (&device);
   g_clear_object (&block_object);
   g_clear_object (&object);
@@ -1740,6 +1911,20 @@ ata_pm_standby_to_string (guint value)
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+/* Maximum number of drives on the same controller being configured at once,
+ * e.g. after resume when all drives need to be reconfigured at the same time
+ */
+#define APPLY_CONF_MAX_PER_CONTROLLER 2
+
+typedef struct
+{
+  GQueue pending;
+  guint running;
+} ApplyConfQueue;
+
+G_LOCK_DEFINE_STATIC (apply_conf_lock);
+static GHashTable *apply_conf_queues = NULL;  /* controller sysfs path -> ApplyConfQueue */
+
 typedef struct
 {
   gint ata_pm_standby;
@@ -1754,11 +1939,14 @@ typedef struct
   GVariant *configuration;
   UDisksDrive *drive;
   UDisksLinuxDriveObject *object;
+  gboolean skip_unchanged;
+  gchar *controller;
 } ApplyConfData;
 
 static void
 apply_conf_data_free (ApplyConfData *data)
 {
+  g_free (data->controller);
   g_clear_object (&data->ata);
   g_clear_object (&data->device);
   g_variant_unref (data->configuration);
@@ -1767,6 +1955,151 @@ apply_conf_data_free (ApplyConfData *data)
   g_free (data);
 }
 
+static void apply_configuration_thread_func (GTask        *task,
+                                             gpointer      source_object,
+                                             gpointer      task_data,
+                                             GCancellable *cancellable);
+
+static void
+apply_conf_queue_free (ApplyConfQueue *queue)
+{
+  g_queue_clear_full (&queue->pending, g_object_unref);
+  g_free (queue);
+}
+
+/* runs @task now or once fewer than APPLY_CONF_MAX_PER_CONTROLLER drives on
+ * the same controller are being configured
+ */
+static void
+apply_conf_schedule (GTask       *task,
+                     const gchar *controller)
+{
+  ApplyConfQueue *queue;
+  gboolean run_now = FALSE;
+
+  G_LOCK (apply_conf_lock);
+  if (apply_conf_queues == NULL)
+    apply_conf_queues = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                               g_free, (GDestroyNotify) apply_conf_queue_free);
+  queue = g_hash_table_lookup (apply_conf_queues, controller);
+  if (queue == NULL)
+    {
+      queue = g_new0 (ApplyConfQueue, 1);
+      g_queue_init (&queue->pending);
+      g_hash_table_insert (apply_conf_queues, g_strdup (controller), queue);
+    }
+  if (queue->running < APPLY_CONF_MAX_PER_CONTROLLER)
+    {
+      queue->running++;
+      run_now = TRUE;
+    }
+  else
+    {
+      g_queue_push_tail (&queue->pending, g_object_ref (task));
+    }
+  G_UNLOCK (apply_conf_lock);
+
+  if (run_now)
+    g_task_run_in_thread (task, apply_configuration_thread_func);
+}
+
+/* called when a drive on @controller is done, starts the next one if any */
+static void
+apply_conf_done (const gchar *controller)
+{
+  ApplyConfQueue *queue;
+  GTask *next = NULL;
+
+  G_LOCK (apply_conf_lock);
+  queue = g_hash_table_lookup (apply_conf_queues, controller);
+  g_assert (queue != NULL);
+  next = g_queue_pop_head (&queue->pending);
+  if (next == NULL)
+    {
+      queue->running--;
+      if (queue->running == 0)
+        g_hash_table_remove (apply_conf_queues, controller);
+    }
+  G_UNLOCK (apply_conf_lock);
+
+  if (next != NULL)
+    {
+      g_task_run_in_thread (next, apply_configuration_thread_func);
+      g_object_unref (next);
+    }
+}
+
+/* Removes settings from @data that are already in effect according to the
+ * IDENTIFY DEVICE data. Settings that can't be read back (the standby timer)
+ * are kept.
+ */
+static void
+apply_conf_skip_unchanged (ApplyConfData *data,
+                           gint           fd,
+                           const gchar   *device_file)
+{
+  union
+  {
+    guchar buf[512];
+    guint16 words[256];
+  } identify;
+  guint16 word_82;
+  guint16 word_83;
+  guint16 word_85;
+  guint16 word_86;
+  guint16 word_91;
+  guint16 word_94;
+  GError *error = NULL;
+
+  /* ATA8: 7.16 IDENTIFY DEVICE - ECh, PIO Data-In */
+  {
+    UDisksAtaCommandInput input = {.command = 0xec, .count = 1};
+    UDisksAtaCommandOutput output = {.buffer = identify.buf, .buffer_size = sizeof (identify.buf)};
+    if (!udisks_ata_send_command_sync (fd,
+                                       -1,
+                                       UDISKS_ATA_COMMAND_PROTOCOL_DRIVE_TO_HOST,
+                                       &input,
+                                       &output,
+                                       &error))
+      {
+        udisks_debug ("Error sending ATA command IDENTIFY DEVICE to %s, applying all settings: %s",
+                      device_file, error->message);
+        g_clear_error (&error);
+        return;
+      }
+  }
+
+  /* ATA8: 7.16 IDENTIFY DEVICE - ECh, PIO Data-In - Table 29 IDENTIFY DEVICE data */
+  word_82 = GUINT16_FROM_LE (identify.words[82]);
+  word_83 = GUINT16_FROM_LE (identify.words[83]);
+  word_85 = GUINT16_FROM_LE (identify.words[85]);
+  word_86 = GUINT16_FROM_LE (identify.words[86]);
+  word_91 = GUINT16_FROM_LE (identify.words[91]);
+  word_94 = GUINT16_FROM_LE (identify.words[94]);
+
+  if (data->ata_write_cache_enabled_set && (word_82 & (1<<5)) &&
+      !!(word_85 & (1<<5)) == !!data->ata_write_cache_enabled)
+    data->ata_write_cache_enabled_set = FALSE;
+
+  if (data->ata_read_lookahead_enabled_set && (word_82 & (1<<6)) &&
+      !!(word_85 & (1<<6)) == !!data->ata_read_lookahead_enabled)
+    data->ata_read_lookahead_enabled_set = FALSE;
+
+  if (data->ata_apm_level != -1 && (word_83 & (1<<3)))
+    {
+      if (data->ata_apm_level == 0xff ? !(word_86 & (1<<3))
+                                      : ((word_86 & (1<<3)) && (word_91 & 0xff) == data->ata_apm_level))
+        data->ata_apm_level = -1;
+    }
+
+  if (data->ata_aam_level != -1 && (word_83 & (1<<9)))
+    {
+      if (data->ata_aam_level == 0xff ? !(word_86 & (1<<9))
+                                      : ((word_86 & (1<<9)) && (word_94 & 0xff) == data->ata_aam_level))
+        data->ata_aam_level = -1;
+    }
+}
+
 static void
 apply_configuration_thread_func (GTask        *task,
                                  gpointer      source_object,
@@ -1794,6 +2127,18 @@ apply_configuration_thread_func (GTask        *task,
       goto out;
     }
 
+  if (data->skip_unchanged)
+    {
+      apply_conf_skip_unchanged (data, fd, device_file);
+      if (data->ata_pm_standby == -1 && data->ata_apm_level == -1 && data->ata_aam_level == -1 &&
+          !data->ata_write_cache_enabled_set && !data->ata_read_lookahead_enabled_set)
+        {
+          udisks_debug ("Configuration of %s [%s] is still in effect",
+                        device_file, udisks_drive_get_id (data->drive));
+          goto out;
+        }
+    }
+
   if (data->ata_apm_level != -1)
     {
       /* ATA8: 7.48 SET FEATURES - EFh, Non-Data
@@ -1944,22 +2289,46 @@ apply_configuration_thread_func (GTask        *task,
  out:
   if (fd != -1)
     close (fd);
+  /* IDLE with a standby timer changes the power state */
+  invalidate_pm_state (data->ata);
+  apply_conf_done (data->controller);
   g_task_return_boolean (task, TRUE);
 }
 
+/* the drives behind the same PCI (or USB) device share the bandwidth of the link */
+static gchar *
+dup_controller_sysfs_path (UDisksLinuxDevice *device)
+{
+  GUdevDevice *parent;
+  gchar *ret;
+
+  parent = g_udev_device_get_parent_with_subsystem (device->udev_device, "pci", NULL);
+  if (parent == NULL)
+    parent = g_udev_device_get_parent_with_subsystem (device->udev_device, "usb", "usb_device");
+  if (parent == NULL)
+    return g_strdup (g_udev_device_get_sysfs_path (device->udev_device));
+
+  ret = g_strdup (g_udev_device_get_sysfs_path (parent));
+  g_object_unref (parent);
+  return ret;
+}
+
 /**
  * udisks_linux_drive_ata_apply_configuration:
  * @drive: A #UDisksLinuxDriveAta.
  * @device: A #UDisksLinuxDevice
  * @configuration: The configuration to apply.
+ * @skip_unchanged: Whether to skip settings the drive reports as already in effect.
  *
  * Spawns a thread to apply @configuration to @drive, if any. Does not
- * wait for the thread to terminate.
+ * wait for the thread to terminate. At most a few drives on the same
+ * controller are configured at the same time, the rest is queued.
  */
 void
 udisks_linux_drive_ata_apply_configuration (UDisksLinuxDriveAta *drive,
                                             UDisksLinuxDevice   *device,
-                                            GVariant            *configuration)
+                                            GVariant            *configuration,
+                                            gboolean             skip_unchanged)
 {
   gboolean has_conf = FALSE;
   ApplyConfData *data = NULL;
@@ -1976,6 +2345,8 @@ udisks_linux_drive_ata_apply_configuration (UDisksLinuxDriveAta *drive,
   data->ata = g_object_ref (drive);
   data->device = g_object_ref (device);
   data->configuration = g_variant_ref (configuration);
+  data->skip_unchanged = skip_unchanged;
+  data->controller = dup_controller_sysfs_path (device);
 
   data->object = udisks_daemon_util_dup_object (drive, NULL);
   if (data->object == NULL)
@@ -2009,7 +2380,7 @@ udisks_linux_drive_ata_apply_configuration (UDisksLinuxDriveAta *drive,
    */
   task = g_task_new (data->object, NULL, NULL, NULL);
   g_task_set_task_data (task, data, (GDestroyNotify) apply_conf_data_free);
-  g_task_run_in_thread (task, apply_configuration_thread_func);
+  apply_conf_schedule (task, data->controller);
   g_object_unref (task);
 
   data = NULL; /* don't free data below */
@@ -45,11 +45,16 @@ gboolean        udisks_linux_drive_ata_secure_erase_sync   (UDisksLinuxDriveAta
 
 void            udisks_linux_drive_ata_apply_configuration (UDisksLinuxDriveAta     *drive,
                                                             UDisksLinuxDevice       *device,
-                                                            GVariant                *configuration);
+                                                            GVariant                *configuration,
+                                                            gboolean                 skip_unchanged);
 
 gboolean        udisks_linux_drive_ata_get_pm_state        (UDisksLinuxDriveAta     *drive,
                                                             GError                 **error,
                                                             guchar                  *pm_state);
+gboolean        udisks_linux_drive_ata_get_pm_state_cached (UDisksLinuxDriveAta     *drive,
+                                                            GError                 **error,
+                                                            guchar                  *pm_state);
+void            udisks_linux_drive_ata_release_device      (UDisksLinuxDriveAta     *drive);
 
 G_END_DECLS
 
@@ -697,7 +697,8 @@ nvme_fabrics_update (UDisksObject   *object,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
-static void apply_configuration (UDisksLinuxDriveObject *object);
+static void apply_configuration (UDisksLinuxDriveObject *object,
+                                 gboolean                skip_unchanged);
 
 static GList *
 find_link_for_sysfs_path (UDisksLinuxDriveObject *object,
@@ -719,6 +720,61 @@ find_link_for_sysfs_path (UDisksLinuxDriveObject *object,
   return ret;
 }
 
+/* returns %TRUE if any module interface was added, removed or updated */
+static gboolean
+update_module_ifaces (UDisksLinuxDriveObject *object,
+                      const gchar            *action,
+                      UDisksLinuxDevice      *device,
+                      GList                  *modules)
+{
+  gboolean changed = FALSE;
+  GList *l;
+
+  for (l = modules; l; l = g_list_next (l))
+    {
+      UDisksModule *module = l->data;
+      GType *types;
+
+      types = udisks_module_get_drive_object_interface_types (module);
+      for (; types && *types; types++)
+        {
+          GDBusInterfaceSkeleton *interface;
+          gboolean keep = TRUE;
+
+          interface = g_hash_table_lookup (object->module_ifaces, GSIZE_TO_POINTER (*types));
+          if (interface != NULL)
+            {
+              /* ask the existing instance to process the uevent */
+              if (udisks_module_object_process_uevent (UDISKS_MODULE_OBJECT (interface),
+                                                       action, device, &keep))
+                {
+                  changed = TRUE;
+                  if (! keep)
+                    {
+                      g_dbus_object_skeleton_remove_interface (G_DBUS_OBJECT_SKELETON (object), interface);
+                      g_hash_table_remove (object->module_ifaces, GSIZE_TO_POINTER (*types));
+                    }
+                }
+            }
+          else
+            {
+              /* try create new interface and see if the module is interested in this object */
+              interface = udisks_module_new_drive_object_interface (module, object, *types);
+              if (interface)
+                {
+                  /* do coldplug after creation */
+                  udisks_module_object_process_uevent (UDISKS_MODULE_OBJECT (interface), action, device, &keep);
+                  g_dbus_object_skeleton_add_interface (G_DBUS_OBJECT_SKELETON (object), interface);
+                  g_warn_if_fail (g_hash_table_replace (object->module_ifaces, GSIZE_TO_POINTER (*types), interface));
+                  changed = TRUE;
+                }
+            }
+        }
+    }
+
+  return changed;
+}
+
 /**
  * udisks_linux_drive_object_uevent:
  * @object: A #UDisksLinuxDriveObject.
@@ -736,7 +792,6 @@ udisks_linux_drive_object_uevent (UDisksLinuxDriveObject *object,
   gboolean conf_changed;
   UDisksModuleManager *module_manager;
   GList *modules;
-  GList *l;
 
   g_return_if_fail (UDISKS_IS_LINUX_DRIVE_OBJECT (object));
   g_return_if_fail (device == NULL || UDISKS_IS_LINUX_DEVICE (device));
@@ -774,6 +829,11 @@ udisks_linux_drive_object_uevent (UDisksLinuxDriveObject *object,
     }
   g_mutex_unlock (&object->devices_mutex);
 
+  /* don't keep the removed device open, other references to the DriveAta
+   * interface (e.g. from filesystems) may outlive the drive object */
+  if (g_strcmp0 (action, "remove") == 0 && object->iface_drive_ata != NULL)
+    udisks_linux_drive_ata_release_device (UDISKS_LINUX_DRIVE_ATA (object->iface_drive_ata));
+
   conf_changed = FALSE;
   conf_changed |= update_iface (UDISKS_OBJECT (object), action, drive_check, drive_connect, drive_update,
                                 UDISKS_TYPE_LINUX_DRIVE, &object->iface_drive);
@@ -787,60 +847,45 @@ udisks_linux_drive_object_uevent (UDisksLinuxDriveObject *object,
   /* Attach interfaces from modules */
   module_manager = udisks_daemon_get_module_manager (object->daemon);
   modules = udisks_module_manager_get_modules (module_manager);
-  for (l = modules; l; l = g_list_next (l))
-    {
-      UDisksModule *module = l->data;
-      GType *types;
-
-      types = udisks_module_get_drive_object_interface_types (module);
-      for (; types && *types; types++)
-        {
-          GDBusInterfaceSkeleton *interface;
-          gboolean keep = TRUE;
-
-          interface = g_hash_table_lookup (object->module_ifaces, GSIZE_TO_POINTER (*types));
-          if (interface != NULL)
-            {
-              /* ask the existing instance to process the uevent */
-              if (udisks_module_object_process_uevent (UDISKS_MODULE_OBJECT (interface),
-                                                       action, device, &keep))
-                {
-                  conf_changed = TRUE;
-                  if (! keep)
-                    {
-                      g_dbus_object_skeleton_remove_interface (G_DBUS_OBJECT_SKELETON (object), interface);
-                      g_hash_table_remove (object->module_ifaces, GSIZE_TO_POINTER (*types));
-                    }
-                }
-            }
-          else
-            {
-              /* try create new interface and see if the module is interested in this object */
-              interface = udisks_module_new_drive_object_interface (module, object, *types);
-              if (interface)
-                {
-                  /* do coldplug after creation */
-                  udisks_module_object_process_uevent (UDISKS_MODULE_OBJECT (interface), action, device, &keep);
-                  g_dbus_object_skeleton_add_interface (G_DBUS_OBJECT_SKELETON (object), interface);
-                  g_warn_if_fail (g_hash_table_replace (object->module_ifaces, GSIZE_TO_POINTER (*types), interface));
-                  conf_changed = TRUE;
-                }
-            }
-        }
-    }
+  conf_changed |= update_module_ifaces (object, action, device, modules);
   g_list_free_full (modules, g_object_unref);
 
+  /* "reconfigure" is synthesized after resume when most settings usually
+   * survived, only changed ones need to be applied again
+   */
   if (g_strcmp0 (action, "reconfigure") == 0)
-    conf_changed = TRUE;
+    apply_configuration (object, TRUE);
+  else if (conf_changed)
+    apply_configuration (object, FALSE);
+}
+
+/**
+ * udisks_linux_drive_object_coldplug_modules:
+ * @object: A #UDisksLinuxDriveObject.
+ * @modules: (element-type UDisksModule): Newly activated modules.
+ *
+ * Attaches interfaces from @modules to @object without updating any
+ * other interfaces.
+ */
+void
+udisks_linux_drive_object_coldplug_modules (UDisksLinuxDriveObject *object,
+                                            GList                  *modules)
+{
+  UDisksLinuxDevice *device;
 
-  if (conf_changed)
-    apply_configuration (object);
+  g_return_if_fail (UDISKS_IS_LINUX_DRIVE_OBJECT (object));
+
+  device = udisks_linux_drive_object_get_device (object, FALSE /* get_hw */);
+  if (update_module_ifaces (object, "add", device, modules))
+    apply_configuration (object, FALSE);
+  g_clear_object (&device);
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
 
 static void
-apply_configuration (UDisksLinuxDriveObject *object)
+apply_configuration (UDisksLinuxDriveObject *object,
+                     gboolean                skip_unchanged)
 {
   GVariant *configuration = NULL;
   UDisksLinuxDevice *device = NULL;
@@ -860,7 +905,8 @@ apply_configuration (UDisksLinuxDriveObject *object)
     {
       udisks_linux_drive_ata_apply_configuration (UDISKS_LINUX_DRIVE_ATA (object->iface_drive_ata),
                                                   device,
-                                                  configuration);
+                                                  configuration,
+                                                  skip_unchanged);
     }
 
  out:
@@ -36,6 +36,8 @@ UDisksLinuxDriveObject *udisks_linux_drive_object_new           (UDisksDaemon
 void                    udisks_linux_drive_object_uevent        (UDisksLinuxDriveObject   *object,
                                                                  const gchar              *action,
                                                                  UDisksLinuxDevice        *device);
+void                    udisks_linux_drive_object_coldplug_modules (UDisksLinuxDriveObject *object,
+                                                                    GList                  *modules);
 UDisksDaemon           *udisks_linux_drive_object_get_daemon    (UDisksLinuxDriveObject   *object);
 GList                  *udisks_linux_drive_object_get_devices   (UDisksLinuxDriveObject   *object);
 UDisksLinuxDevice      *udisks_linux_drive_object_get_device    (UDisksLinuxDriveObject   *object,
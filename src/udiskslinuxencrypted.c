@@ -240,7 +240,7 @@ udisks_linux_encrypted_update (UDisksLinuxEncrypted   *encrypted,
 
   udisks_linux_block_encrypted_unlock (block);
 
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (encrypted));
+  udisks_daemon_util_flush_interface (encrypted);
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
@@ -81,7 +81,7 @@ struct _UDisksLinuxFilesystem
   guint64 cached_fs_size;
   gchar *cached_device_file;
   gchar *cached_fs_type;
-  gboolean cached_drive_is_ata;
+  UDisksLinuxDriveAta *cached_drive_ata;
 };
 
 struct _UDisksLinuxFilesystemClass
@@ -159,6 +159,7 @@ udisks_linux_filesystem_finalize (GObject *object)
   g_mutex_clear (&(filesystem->lock));
   g_free (filesystem->cached_device_file);
   g_free (filesystem->cached_fs_type);
+  g_clear_object (&filesystem->cached_drive_ata);
 
   if (G_OBJECT_CLASS (udisks_linux_filesystem_parent_class)->finalize != NULL)
     G_OBJECT_CLASS (udisks_linux_filesystem_parent_class)->finalize (object);
@@ -269,11 +270,11 @@ get_filesystem_size (UDisksLinuxFilesystem *filesystem)
   /* if the drive is ATA and is sleeping, skip filesystem size check to prevent
    * drive waking up - nothing has changed anyway since it's been sleeping...
    */
-  if (filesystem->cached_drive_is_ata)
+  if (filesystem->cached_drive_ata != NULL)
     {
       guchar pm_state = 0;
 
-      if (udisks_ata_get_pm_state (filesystem->cached_device_file, NULL, &pm_state))
+      if (udisks_linux_drive_ata_get_pm_state_cached (filesystem->cached_drive_ata, NULL, &pm_state))
         if (!UDISKS_ATA_PM_STATE_AWAKE (pm_state))
           return 0;
     }
@@ -387,10 +388,12 @@ udisks_linux_filesystem_update (UDisksLinuxFilesystem  *filesystem,
    * the tree and return a list of physical drives to check the powermanagement on.
    */
   ata = get_drive_ata (object);
-  filesystem->cached_drive_is_ata = ata != NULL && udisks_drive_ata_get_pm_supported (ata);
+  g_clear_object (&filesystem->cached_drive_ata);
+  if (ata != NULL && udisks_drive_ata_get_pm_supported (ata))
+    filesystem->cached_drive_ata = UDISKS_LINUX_DRIVE_ATA (g_object_ref (ata));
   g_clear_object (&ata);
 
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (filesystem));
+  udisks_daemon_util_flush_interface (filesystem);
 
   if (mounted && g_strcmp0 (filesystem->cached_fs_type, "xfs") == 0)
     /* Force native filesystem tools for mounted XFS as superblock might
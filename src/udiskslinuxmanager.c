@@ -37,6 +37,8 @@
 #include <blockdev/fs.h>
 #include <blockdev/mdraid.h>
 
+#include <blkid/blkid.h>
+
 #include "udiskslogging.h"
 #include "udiskslinuxmanager.h"
 #include "udisksdaemon.h"
@@ -1238,6 +1240,8 @@ handle_resolve_device (UDisksManager         *object,
   const gchar *devlabel = NULL;
   const gchar *partuuid = NULL;
   const gchar *partlabel = NULL;
+  guint64 devnum = 0;
+  gboolean have_devnum;
 
   GSList *blocks = NULL;
   GSList *blocks_p = NULL;
@@ -1255,8 +1259,9 @@ handle_resolve_device (UDisksManager         *object,
   g_variant_lookup (arg_devspec, "label", "&s", &devlabel);
   g_variant_lookup (arg_devspec, "partuuid", "&s", &partuuid);
   g_variant_lookup (arg_devspec, "partlabel", "&s", &partlabel);
+  have_devnum = g_variant_lookup (arg_devspec, "devnum", "t", &devnum);
 
-  if (!devpath && !devuuid && !devlabel && !partuuid && !partlabel)
+  if (!devpath && !devuuid && !devlabel && !partuuid && !partlabel && !have_devnum)
     {
       g_dbus_method_invocation_return_error_literal (invocation, UDISKS_ERROR, UDISKS_ERROR_FAILED,
                                                      "Invalid device specification provided");
@@ -1270,6 +1275,9 @@ handle_resolve_device (UDisksManager         *object,
       UDisksLinuxBlock *block = UDISKS_LINUX_BLOCK (blocks_p->data);
       gboolean found = TRUE;
 
+      /* cheapest check first, this is what the umount helper uses */
+      if (have_devnum && udisks_block_get_device_number (UDISKS_BLOCK (block)) != devnum)
+        continue;
       if (devpath != NULL)
           found = udisks_linux_block_matches_id (block, devpath);
       if (devuuid != NULL)
@@ -1307,6 +1315,454 @@ handle_resolve_device (UDisksManager         *object,
   return TRUE;  /* returning TRUE means that we handled the method invocation */
 }
 
+static gboolean
+has_any_prefix (const gchar *const *prefixes,
+                const gchar        *str)
+{
+  guint n;
+
+  for (n = 0; prefixes[n] != NULL; n++)
+    {
+      if (g_str_has_prefix (str, prefixes[n]))
+        return TRUE;
+    }
+  return FALSE;
+}
+
+/* Adds @object with those of its interfaces listed in @interface_names
+ * (all if %NULL) and those of their properties listed in
+ * @property_names (all if %NULL) to @builder of type a{oa{sa{sv}}}.
+ * Objects without any matching interface are skipped.
+ */
+static void
+add_object_interfaces (GVariantBuilder    *builder,
+                       GDBusObject        *object,
+                       const gchar *const *interface_names,
+                       const gchar *const *property_names)
+{
+  GVariantBuilder interfaces_builder;
+  GList *interfaces;
+  GList *l;
+  gboolean have_interfaces = FALSE;
+
+  g_variant_builder_init (&interfaces_builder, G_VARIANT_TYPE ("a{sa{sv}}"));
+  interfaces = g_dbus_object_get_interfaces (object);
+  for (l = interfaces; l != NULL; l = l->next)
+    {
+      GDBusInterfaceSkeleton *iface = G_DBUS_INTERFACE_SKELETON (l->data);
+      const gchar *interface_name = g_dbus_interface_skeleton_get_info (iface)->name;
+      GVariant *properties;
+
+      if (interface_names != NULL && !g_strv_contains (interface_names, interface_name))
+        continue;
+
+      properties = g_variant_ref_sink (g_dbus_interface_skeleton_get_properties (iface));
+      if (property_names != NULL)
+        {
+          GVariantBuilder properties_builder;
+          GVariantIter iter;
+          const gchar *property_name;
+          GVariant *value;
+
+          g_variant_builder_init (&properties_builder, G_VARIANT_TYPE_VARDICT);
+          g_variant_iter_init (&iter, properties);
+          while (g_variant_iter_next (&iter, "{&sv}", &property_name, &value))
+            {
+              if (g_strv_contains (property_names, property_name))
+                g_variant_builder_add (&properties_builder, "{sv}", property_name, value);
+              g_variant_unref (value);
+            }
+          g_variant_builder_add (&interfaces_builder, "{sa{sv}}", interface_name, &properties_builder);
+        }
+      else
+        {
+          g_variant_builder_add (&interfaces_builder, "{s@a{sv}}", interface_name, properties);
+        }
+      g_variant_unref (properties);
+      have_interfaces = TRUE;
+    }
+  g_list_free_full (interfaces, g_object_unref);
+
+  if (have_interfaces)
+    g_variant_builder_add (builder, "{oa{sa{sv}}}", g_dbus_object_get_object_path (object), &interfaces_builder);
+  else
+    g_variant_builder_clear (&interfaces_builder);
+}
+
+static gboolean
+object_has_any_interface (GDBusObject        *object,
+                          const gchar *const *interface_names)
+{
+  guint n;
+
+  for (n = 0; interface_names[n] != NULL; n++)
+    {
+      GDBusInterface *iface = g_dbus_object_get_interface (object, interface_names[n]);
+      if (iface != NULL)
+        {
+          g_object_unref (iface);
+          return TRUE;
+        }
+    }
+  return FALSE;
+}
+
+static gboolean
+handle_get_objects (UDisksManager         *object,
+                    GDBusMethodInvocation *invocation,
+                    GVariant              *arg_options)
+{
+  UDisksLinuxManager *manager = UDISKS_LINUX_MANAGER (object);
+  GDBusObjectManagerServer *object_manager;
+  const gchar **interface_names = NULL;
+  const gchar **prefixes = NULL;
+  GVariantBuilder objects_builder;
+  GList *objects;
+  GList *l;
+
+  g_variant_lookup (arg_options, "interfaces", "^a&s", &interface_names);
+  g_variant_lookup (arg_options, "object-path-prefixes", "^a&s", &prefixes);
+
+  g_variant_builder_init (&objects_builder, G_VARIANT_TYPE ("a{oa{sa{sv}}}"));
+
+  object_manager = udisks_daemon_get_object_manager (manager->daemon);
+  objects = g_dbus_object_manager_get_objects (G_DBUS_OBJECT_MANAGER (object_manager));
+  for (l = objects; l != NULL; l = l->next)
+    {
+      GDBusObject *dbus_object = G_DBUS_OBJECT (l->data);
+      const gchar *object_path = g_dbus_object_get_object_path (dbus_object);
+
+      if (prefixes != NULL && !has_any_prefix (prefixes, object_path))
+        continue;
+
+      add_object_interfaces (&objects_builder, dbus_object, interface_names, NULL);
+    }
+  g_list_free_full (objects, g_object_unref);
+
+  udisks_manager_complete_get_objects (object,
+                                       invocation,
+                                       g_variant_builder_end (&objects_builder));
+
+  g_free (interface_names);
+  g_free (prefixes);
+
+  return TRUE;  /* returning TRUE means that we handled the method invocation */
+}
+
+static gint
+block_object_path_cmp (gconstpointer a,
+                       gconstpointer b)
+{
+  GDBusObject *object_a = g_dbus_interface_get_object (G_DBUS_INTERFACE ((gpointer) a));
+  GDBusObject *object_b = g_dbus_interface_get_object (G_DBUS_INTERFACE ((gpointer) b));
+
+  return g_strcmp0 (object_a != NULL ? g_dbus_object_get_object_path (object_a) : NULL,
+                    object_b != NULL ? g_dbus_object_get_object_path (object_b) : NULL);
+}
+
+static gboolean
+block_is_mounted (GDBusObject *object)
+{
+  UDisksFilesystem *filesystem;
+  const gchar *const *mount_points;
+
+  filesystem = udisks_object_peek_filesystem (UDISKS_OBJECT (object));
+  if (filesystem == NULL)
+    return FALSE;
+
+  mount_points = udisks_filesystem_get_mount_points (filesystem);
+  return mount_points != NULL && mount_points[0] != NULL;
+}
+
+static gboolean
+handle_query_block_devices (UDisksManager         *object,
+                            GDBusMethodInvocation *invocation,
+                            GVariant              *arg_options)
+{
+  const gchar **interface_names = NULL;
+  const gchar **property_names = NULL;
+  const gchar *id_type = NULL;
+  const gchar *id_usage = NULL;
+  const gchar *drive = NULL;
+  gboolean mounted = FALSE;
+  gboolean have_mounted;
+  guint32 offset = 0;
+  guint32 limit = 0;
+  GSList *blocks = NULL;
+  GSList *blocks_p = NULL;
+  guint num_blocks = 0;
+  guint32 total = 0;
+  GVariantBuilder devices_builder;
+
+  g_variant_lookup (arg_options, "interfaces", "^a&s", &interface_names);
+  g_variant_lookup (arg_options, "properties", "^a&s", &property_names);
+  g_variant_lookup (arg_options, "id-type", "&s", &id_type);
+  g_variant_lookup (arg_options, "id-usage", "&s", &id_usage);
+  g_variant_lookup (arg_options, "drive", "&o", &drive);
+  have_mounted = g_variant_lookup (arg_options, "mounted", "b", &mounted);
+  g_variant_lookup (arg_options, "offset", "u", &offset);
+  g_variant_lookup (arg_options, "limit", "u", &limit);
+
+  g_variant_builder_init (&devices_builder, G_VARIANT_TYPE ("a{oa{sa{sv}}}"));
+
+  /* sort by object path so that paging through the results is stable */
+  blocks = get_block_objects (object, &num_blocks);
+  blocks = g_slist_sort (blocks, block_object_path_cmp);
+
+  for (blocks_p = blocks; blocks_p != NULL; blocks_p = blocks_p->next)
+    {
+      UDisksBlock *block = UDISKS_BLOCK (blocks_p->data);
+      GDBusObject *block_object;
+
+      block_object = g_dbus_interface_get_object (G_DBUS_INTERFACE (block));
+      if (block_object == NULL)
+        continue;
+
+      if (id_type != NULL && g_strcmp0 (udisks_block_get_id_type (block), id_type) != 0)
+        continue;
+      if (id_usage != NULL && g_strcmp0 (udisks_block_get_id_usage (block), id_usage) != 0)
+        continue;
+      if (drive != NULL && g_strcmp0 (udisks_block_get_drive (block), drive) != 0)
+        continue;
+      if (have_mounted && block_is_mounted (block_object) != mounted)
+        continue;
+      /* add_object_interfaces() skips such objects, don't count them */
+      if (interface_names != NULL && !object_has_any_interface (block_object, interface_names))
+        continue;
+
+      total++;
+      if (total <= offset || (limit > 0 && total > (guint64) offset + limit))
+        continue;
+
+      add_object_interfaces (&devices_builder, block_object, interface_names, property_names);
+    }
+
+  udisks_manager_complete_query_block_devices (object,
+                                               invocation,
+                                               g_variant_builder_end (&devices_builder),
+                                               total);
+
+  g_slist_free_full (blocks, g_object_unref);
+  g_free (interface_names);
+  g_free (property_names);
+
+  return TRUE;  /* returning TRUE means that we handled the method invocation */
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+/* Index of all block objects by identifier, built once per
+ * ResolveDevices() call. Keys are "<kind>\t<value>" strings, values are
+ * arrays of (borrowed) objects.
+ */
+static void
+resolve_index_add (GHashTable  *index,
+                   const gchar *kind,
+                   const gchar *value,
+                   GDBusObject *object)
+{
+  GPtrArray *objects;
+  gchar *key;
+
+  if (value == NULL || *value == '\0')
+    return;
+
+  key = g_strdup_printf ("%s\t%s", kind, value);
+  objects = g_hash_table_lookup (index, key);
+  if (objects == NULL)
+    {
+      objects = g_ptr_array_new ();
+      g_hash_table_insert (index, key, objects);
+    }
+  else
+    {
+      g_free (key);
+    }
+  if (!g_ptr_array_find (objects, object, NULL))
+    g_ptr_array_add (objects, object);
+}
+
+static GHashTable *
+resolve_index_new (GSList *blocks)
+{
+  GHashTable *index;
+  GSList *l;
+
+  index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+  for (l = blocks; l != NULL; l = l->next)
+    {
+      UDisksBlock *block = UDISKS_BLOCK (l->data);
+      GDBusObject *object;
+      UDisksPartition *partition;
+      const gchar *const *symlinks;
+      gchar devnum[32];
+      guint n;
+
+      object = g_dbus_interface_get_object (G_DBUS_INTERFACE (block));
+      if (object == NULL)
+        continue;
+
+      resolve_index_add (index, "path", udisks_block_get_device (block), object);
+      symlinks = udisks_block_get_symlinks (block);
+      for (n = 0; symlinks != NULL && symlinks[n] != NULL; n++)
+        resolve_index_add (index, "path", symlinks[n], object);
+      resolve_index_add (index, "uuid", udisks_block_get_id_uuid (block), object);
+      resolve_index_add (index, "label", udisks_block_get_id_label (block), object);
+      g_snprintf (devnum, sizeof (devnum), "%" G_GUINT64_FORMAT, udisks_block_get_device_number (block));
+      resolve_index_add (index, "devnum", devnum, object);
+
+      partition = udisks_object_peek_partition (UDISKS_OBJECT (object));
+      if (partition != NULL)
+        {
+          resolve_index_add (index, "partuuid", udisks_partition_get_uuid (partition), object);
+          resolve_index_add (index, "partlabel", udisks_partition_get_name (partition), object);
+        }
+    }
+  return index;
+}
+
+static gint
+object_path_cmp (gconstpointer a,
+                 gconstpointer b)
+{
+  GDBusObject *object_a = *((GDBusObject **) a);
+  GDBusObject *object_b = *((GDBusObject **) b);
+
+  return g_strcmp0 (g_dbus_object_get_object_path (object_a), g_dbus_object_get_object_path (object_b));
+}
+
+/* Returns the objects matching all the keys in @devspec, sorted by object path */
+static GPtrArray *
+resolve_devspec (GHashTable  *index,
+                 GVariant    *devspec,
+                 GError     **error)
+{
+  static const gchar *const kinds[] = { "path", "uuid", "label", "partuuid", "partlabel", "devnum", NULL };
+  GPtrArray *ret = NULL;
+  gboolean have_key = FALSE;
+  guint n;
+
+  for (n = 0; kinds[n] != NULL; n++)
+    {
+      const gchar *kind = kinds[n];
+      const gchar *value = NULL;
+      gchar *tag_type = NULL;
+      gchar *tag_val = NULL;
+      gchar *key;
+      GPtrArray *objects;
+      guint64 devnum;
+      guint m;
+
+      if (g_str_equal (kind, "devnum"))
+        {
+          if (!g_variant_lookup (devspec, kind, "t", &devnum))
+            continue;
+          key = g_strdup_printf ("%s\t%" G_GUINT64_FORMAT, kind, devnum);
+        }
+      else
+        {
+          if (!g_variant_lookup (devspec, kind, "&s", &value))
+            continue;
+          /* like ResolveDevice(), accept "UUID=..." style tags as path,
+           * the tag names are case-sensitive there as well */
+          if (g_str_equal (kind, "path") &&
+              blkid_parse_tag_string (value, &tag_type, &tag_val) == 0 && tag_type != NULL && tag_val != NULL &&
+              (g_str_equal (tag_type, "UUID") || g_str_equal (tag_type, "LABEL") ||
+               g_str_equal (tag_type, "PARTUUID") || g_str_equal (tag_type, "PARTLABEL")))
+            {
+              gchar *tag_kind = g_ascii_strdown (tag_type, -1);
+              key = g_strdup_printf ("%s\t%s", tag_kind, tag_val);
+              g_free (tag_kind);
+            }
+          else
+            {
+              key = g_strdup_printf ("%s\t%s", kind, value);
+            }
+          g_free (tag_type);
+          g_free (tag_val);
+        }
+
+      objects = g_hash_table_lookup (index, key);
+      g_free (key);
+
+      if (!have_key)
+        {
+          ret = g_ptr_array_new ();
+          for (m = 0; objects != NULL && m < objects->len; m++)
+            g_ptr_array_add (ret, objects->pdata[m]);
+          have_key = TRUE;
+        }
+      else
+        {
+          for (m = 0; m < ret->len;)
+            {
+              if (objects != NULL && g_ptr_array_find (objects, ret->pdata[m], NULL))
+                m++;
+              else
+                g_ptr_array_remove_index (ret, m);
+            }
+        }
+    }
+
+  if (!have_key)
+    {
+      g_set_error_literal (error, UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                           "Invalid device specification provided");
+      return NULL;
+    }
+
+  g_ptr_array_sort (ret, object_path_cmp);
+  return ret;
+}
+
+static gboolean
+handle_resolve_devices (UDisksManager         *object,
+                        GDBusMethodInvocation *invocation,
+                        GVariant              *arg_devspecs,
+                        GVariant              *arg_options)
+{
+  GSList *blocks = NULL;
+  guint num_blocks = 0;
+  GHashTable *index;
+  GVariantBuilder results_builder;
+  GVariantIter iter;
+  GVariant *devspec;
+
+  blocks = get_block_objects (object, &num_blocks);
+  index = resolve_index_new (blocks);
+
+  g_variant_builder_init (&results_builder, G_VARIANT_TYPE ("a(aos)"));
+  g_variant_iter_init (&iter, arg_devspecs);
+  while ((devspec = g_variant_iter_next_value (&iter)) != NULL)
+    {
+      GVariantBuilder paths_builder;
+      GPtrArray *objects;
+      GError *error = NULL;
+      guint n;
+
+      g_variant_builder_init (&paths_builder, G_VARIANT_TYPE_OBJECT_PATH_ARRAY);
+      objects = resolve_devspec (index, devspec, &error);
+      if (objects != NULL)
+        {
+          for (n = 0; n < objects->len; n++)
+            g_variant_builder_add (&paths_builder, "o", g_dbus_object_get_object_path (objects->pdata[n]));
+          g_ptr_array_unref (objects);
+        }
+      g_variant_builder_add (&results_builder, "(aos)", &paths_builder, error != NULL ? error->message : "");
+      g_clear_error (&error);
+      g_variant_unref (devspec);
+    }
+
+  udisks_manager_complete_resolve_devices (object,
+                                           invocation,
+                                           g_variant_builder_end (&results_builder));
+
+  g_hash_table_unref (index);
+  g_slist_free_full (blocks, g_object_unref);
+
+  return TRUE;  /* returning TRUE means that we handled the method invocation */
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 static void
@@ -1322,4 +1778,7 @@ manager_iface_init (UDisksManagerIface *iface)
   iface->handle_can_repair = handle_can_repair;
   iface->handle_get_block_devices = handle_get_block_devices;
   iface->handle_resolve_device = handle_resolve_device;
+  iface->handle_resolve_devices = handle_resolve_devices;
+  iface->handle_get_objects = handle_get_objects;
+  iface->handle_query_block_devices = handle_query_block_devices;
 }
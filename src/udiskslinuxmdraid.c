@@ -46,6 +46,7 @@
 #include "udiskslinuxdevice.h"
 #include "udiskslinuxblock.h"
 #include "udiskssimplejob.h"
+#include "udisksconfigmanager.h"
 
 /**
  * SECTION:udiskslinuxmdraid
@@ -77,7 +78,8 @@ struct _UDisksLinuxMDRaidClass
 };
 
 static void ensure_polling (UDisksLinuxMDRaid  *mdraid,
-                            gboolean            polling_on);
+                            gboolean            polling_on,
+                            guint               interval);
 
 static void mdraid_iface_init (UDisksMDRaidIface *iface);
 
@@ -91,7 +93,7 @@ udisks_linux_mdraid_finalize (GObject *object)
 {
   UDisksLinuxMDRaid *mdraid = UDISKS_LINUX_MDRAID (object);
 
-  ensure_polling (mdraid, FALSE);
+  ensure_polling (mdraid, FALSE, 0);
 
   if (G_OBJECT_CLASS (udisks_linux_mdraid_parent_class)->finalize != NULL)
     G_OBJECT_CLASS (udisks_linux_mdraid_parent_class)->finalize (object);
@@ -155,17 +157,19 @@ on_polling_timout (gpointer user_data)
   return TRUE; /* keep timeout around */
 }
 
+/* @interval is in milliseconds, we never poll more often than once a second */
 static void
 ensure_polling (UDisksLinuxMDRaid  *mdraid,
-                gboolean            polling_on)
+                gboolean            polling_on,
+                guint               interval)
 {
   if (polling_on)
     {
       if (mdraid->polling_timeout == 0)
         {
-          mdraid->polling_timeout = g_timeout_add_seconds (1,
-                                                           on_polling_timout,
-                                                           mdraid);
+          mdraid->polling_timeout = g_timeout_add (MAX (interval, 1000),
+                                                   on_polling_timout,
+                                                   mdraid);
         }
     }
   else
@@ -392,17 +396,21 @@ udisks_linux_mdraid_update (UDisksLinuxMDRaid       *mdraid,
   udisks_mdraid_set_sync_rate (iface, sync_rate);
   udisks_mdraid_set_sync_remaining_time (iface, sync_remaining_time);
 
-  /* ensure we poll, exactly when we need to */
+  /* ensure we poll, exactly when we need to - the sync progress properties
+   * change on every poll so the interval is configurable to limit the number
+   * of D-Bus signals for long running syncs
+   */
   if (g_strcmp0 (sync_action, "resync") == 0 ||
       g_strcmp0 (sync_action, "recover") == 0 ||
       g_strcmp0 (sync_action, "check") == 0 ||
       g_strcmp0 (sync_action, "repair") == 0)
     {
-      ensure_polling (mdraid, TRUE);
+      ensure_polling (mdraid, TRUE,
+                      udisks_config_manager_get_progress_update_interval (udisks_daemon_get_config_manager (daemon)));
     }
   else
     {
-      ensure_polling (mdraid, FALSE);
+      ensure_polling (mdraid, FALSE, 0);
     }
 
   /* figure out active devices */
@@ -515,7 +523,7 @@ udisks_linux_mdraid_update (UDisksLinuxMDRaid       *mdraid,
                                                                                 uuid));
 
  out:
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (mdraid));
+  udisks_daemon_util_flush_interface (mdraid);
   if (raid_data)
       bd_md_examine_data_free (raid_data);
   g_free (sync_completed);
@@ -321,7 +321,7 @@ udisks_linux_nvme_controller_update (UDisksLinuxNVMeController *ctrl,
 
   g_object_thaw_notify (G_OBJECT (object));
 
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (ctrl));
+  udisks_daemon_util_flush_interface (ctrl);
   g_object_unref (device);
 
   g_free (subsysnqn);
@@ -211,7 +211,7 @@ udisks_linux_nvme_namespace_update (UDisksLinuxNVMeNamespace *ns,
   g_mutex_unlock (&ns->format_lock);
 
   g_object_thaw_notify (G_OBJECT (object));
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (ns));
+  udisks_daemon_util_flush_interface (ns);
   g_object_unref (device);
 }
 
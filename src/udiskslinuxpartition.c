@@ -328,7 +328,7 @@ udisks_linux_partition_update (UDisksLinuxPartition   *partition,
   udisks_partition_set_is_container (UDISKS_PARTITION (partition), is_container);
   udisks_partition_set_is_contained (UDISKS_PARTITION (partition), is_contained);
 
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (partition));
+  udisks_daemon_util_flush_interface (partition);
 
   g_free (name);
   g_clear_object (&device);
@@ -953,7 +953,7 @@ handle_resize (UDisksPartition       *partition,
   UDisksBaseJob *job = NULL;
   UDisksObject *partition_object = NULL;
   WaitForPartitionResizeData wait_data;
-  gint fd = 0;
+  BDPartSpec *part_spec = NULL;
   const gchar *part = NULL;
 
   if (!check_authorization (partition, invocation, options, &caller_uid))
@@ -1007,25 +1007,45 @@ handle_resize (UDisksPartition       *partition,
       goto out;
     }
 
+  /* Tell the kernel about the new size of just this partition so that only
+   * the partition itself gets an uevent, a full BLKRRPART would fail with
+   * EBUSY if any other partition on the disk is in use and would make
+   * every partition disappear and reappear.
+   */
+  part_spec = bd_part_get_part_spec (udisks_block_get_device (partition_table_block), part, &error);
+  if (part_spec != NULL)
+    {
+      wait_data.new_size = part_spec->size;
+      if (!udisks_linux_block_object_resize_partition (UDISKS_LINUX_BLOCK_OBJECT (partition_table_object),
+                                                       udisks_partition_get_number (partition),
+                                                       part_spec->start,
+                                                       part_spec->size,
+                                                       &error))
+        {
+          udisks_warning ("%s, falling back to re-reading the partition table", error->message);
+          g_clear_error (&error);
+          if (!udisks_linux_block_object_reread_partition_table (UDISKS_LINUX_BLOCK_OBJECT (partition_table_object), &error))
+            {
+              udisks_warning ("%s", error->message);
+              g_clear_error (&error);
+            }
+        }
+    }
+  else
+    {
+      udisks_warning ("Could not query new partition size for %s: %s", part, error->message);
+      g_clear_error (&error);
+    }
+
   /* Wait for partition property to be updated so that the partition interface
    * will not disappear shortly after this method returns.
    * Clients could either explicitly wait for an interface or try
    * udisks_client_settle() to wait for interfaces to be present.
    * If the partition size wasn't changed then there won't be any reappearing
    * of the partition node or the interfaces.
+   * The uevent goes to the disk as the PartitionTable properties are only
+   * refreshed from it, the disk update also covers its partitions.
    */
-
-  fd = open (part, O_RDONLY);
-  if (fd != -1) {
-    if (ioctl (fd, BLKGETSIZE64, &wait_data.new_size) == -1) {
-        udisks_warning ("Could not query new partition size for %s", part);
-    }
-
-    close (fd);
-  } else {
-    udisks_warning ("Could not open %s to query new partition size", part);
-  }
-
   udisks_linux_block_object_trigger_uevent_sync (UDISKS_LINUX_BLOCK_OBJECT (partition_table_object ? partition_table_object : object),
                                                  UDISKS_DEFAULT_WAIT_TIMEOUT);
   partition_object = udisks_daemon_wait_for_object_sync (daemon,
@@ -1049,6 +1069,8 @@ handle_resize (UDisksPartition       *partition,
   g_clear_object (&partition_object);
   g_clear_object (&partition_table_object);
   g_clear_object (&partition_table_block);
+  if (part_spec != NULL)
+    bd_part_spec_free (part_spec);
 
   return TRUE; /* returning TRUE means that we handled the method invocation */
 
@@ -1135,7 +1157,21 @@ handle_delete (UDisksPartition       *partition,
       udisks_simple_job_complete (UDISKS_SIMPLE_JOB (job), FALSE, error->message);
       goto out;
     }
-  /* this is sometimes needed because parted(8) does not generate the uevent itself */
+  /* drop just this partition from the kernel view, the kernel then only
+   * generates a remove uevent for it instead of re-reading the whole table */
+  if (!udisks_linux_block_object_delete_partition (UDISKS_LINUX_BLOCK_OBJECT (partition_table_object),
+                                                   udisks_partition_get_number (partition),
+                                                   &error))
+    {
+      udisks_warning ("%s, falling back to re-reading the partition table", error->message);
+      g_clear_error (&error);
+      if (!udisks_linux_block_object_reread_partition_table (UDISKS_LINUX_BLOCK_OBJECT (partition_table_object), &error))
+        {
+          udisks_warning ("%s", error->message);
+          g_clear_error (&error);
+        }
+    }
+  /* the PartitionTable.Partitions property is only refreshed on the disk uevent */
   udisks_linux_block_object_trigger_uevent_sync (UDISKS_LINUX_BLOCK_OBJECT (partition_table_object),
                                                  UDISKS_DEFAULT_WAIT_TIMEOUT);
 
@@ -171,7 +171,7 @@ udisks_linux_partition_table_update (UDisksLinuxPartitionTable  *table,
     }
   udisks_partition_table_set_type_ (UDISKS_PARTITION_TABLE (table), part_type);
 
-  g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (table));
+  udisks_daemon_util_flush_interface (table);
 
   g_free (partition_object_paths);
   g_clear_object (&device);
@@ -70,6 +70,10 @@ struct _UDisksLinuxProvider
   GAsyncQueue *probe_request_queue;
   GThread *probe_request_thread;
 
+  /* probed requests waiting to be handled in the main thread */
+  GAsyncQueue *probed_request_queue;
+  gint probed_request_idle_pending;
+
   UDisksObjectSkeleton *manager_object;
 
   /* maps from sysfs path to UDisksLinuxBlockObject objects */
@@ -79,6 +83,12 @@ struct _UDisksLinuxProvider
   GHashTable *vpd_to_drive;
   GHashTable *sysfs_path_to_drive;
 
+  /* maps from Drive:Id to UDisksLinuxDriveObject instances, rebuilt from
+   * vpd_to_drive on lookup when id_to_drive_dirty is set
+   */
+  GHashTable *id_to_drive;
+  gboolean id_to_drive_dirty;
+
   /* maps from array UUID and sysfs_path to UDisksLinuxMDRaidObject instances */
   GHashTable *uuid_to_mdraid;
   GHashTable *sysfs_path_to_mdraid;
@@ -87,12 +97,26 @@ struct _UDisksLinuxProvider
   /* maps from UDisksModule to nested hashtables containing object skeleton instances */
   GHashTable *module_objects;
 
+  /* claim registry for module objects, see udisks_module_object_get_claims():
+   *   module_object_claims: claim -> set of module objects
+   *   module_object_to_claims: module object -> claims (gchar **)
+   *   module_object_claim_properties: udev property name -> number of claims using it
+   *   module_objects_unclaimed: UDisksModule -> set of module objects not supporting claims
+   */
+  GHashTable *module_object_claims;
+  GHashTable *module_object_to_claims;
+  GHashTable *module_object_claim_properties;
+  GHashTable *module_objects_unclaimed;
+
   GUnixMountMonitor *mount_monitor;
   GFileMonitor *etc_udisks2_dir_monitor;
 
   /* Module interfaces hashtable */
   GHashTable *module_ifaces;
 
+  /* names of modules that existing objects have been coldplugged with */
+  GHashTable *coldplugged_modules;
+
   /* set to TRUE only in the coldplug phase */
   gboolean coldplug;
 
@@ -146,6 +170,10 @@ static void on_etc_udisks2_dir_monitor_changed (GFileMonitor     *monitor,
 
 static void detach_module_interfaces (UDisksLinuxProvider *provider);
 static void ensure_modules (UDisksLinuxProvider *provider);
+static void handle_block_uevent_for_module_list (UDisksLinuxProvider *provider,
+                                                 const gchar         *action,
+                                                 UDisksLinuxDevice   *device,
+                                                 GList               *modules);
 
 enum
   {
@@ -174,6 +202,7 @@ udisks_linux_provider_finalize (GObject *object)
   g_async_queue_push (provider->probe_request_queue, (gpointer) 0xdeadbeef);
   g_thread_join (provider->probe_request_thread);
   g_async_queue_unref (provider->probe_request_queue);
+  g_async_queue_unref (provider->probed_request_queue);
 
   daemon = udisks_provider_get_daemon (UDISKS_PROVIDER (provider));
 
@@ -192,13 +221,19 @@ udisks_linux_provider_finalize (GObject *object)
   g_hash_table_unref (provider->sysfs_to_block);
   g_hash_table_unref (provider->vpd_to_drive);
   g_hash_table_unref (provider->sysfs_path_to_drive);
+  g_hash_table_unref (provider->id_to_drive);
   g_hash_table_unref (provider->uuid_to_mdraid);
   g_hash_table_unref (provider->sysfs_path_to_mdraid);
   g_hash_table_unref (provider->sysfs_path_to_mdraid_members);
   g_hash_table_unref (provider->module_objects);
+  g_hash_table_unref (provider->module_object_claims);
+  g_hash_table_unref (provider->module_object_to_claims);
+  g_hash_table_unref (provider->module_object_claim_properties);
+  g_hash_table_unref (provider->module_objects_unclaimed);
   g_object_unref (provider->gudev_client);
 
   g_hash_table_unref (provider->module_ifaces);
+  g_hash_table_unref (provider->coldplugged_modules);
 
   udisks_object_skeleton_set_manager (provider->manager_object, NULL);
   g_object_unref (provider->manager_object);
@@ -243,22 +278,57 @@ probe_request_free (ProbeRequest *request)
 
 /* ---------------------------------------------------------------------------------------------------- */
 
-/* called in main thread with a processed ProbeRequest struct - see probe_request_thread_func() */
+/* Maximum number of probed uevents handled in a single main loop iteration */
+#define PROBED_UEVENTS_BATCH_MAX 64
+
+/* called in main thread with processed ProbeRequest structs - see probe_request_thread_func()
+ *
+ * All uevents that are ready are handled in one go (up to PROBED_UEVENTS_BATCH_MAX) with
+ * property change notifications frozen so that a burst of uevents for the same object results
+ * in a single PropertiesChanged signal per interface.
+ */
 static gboolean
-on_idle_with_probed_uevent (gpointer user_data)
+on_idle_with_probed_uevents (gpointer user_data)
 {
-  ProbeRequest *request = user_data;
-
-  udisks_linux_provider_handle_uevent (request->provider,
-                                       g_udev_device_get_action (request->udev_device),
-                                       request->udisks_device);
-  g_signal_emit (request->provider,
-                 signals[UEVENT_PROBED_SIGNAL],
-                 0,
-                 g_udev_device_get_action (request->udev_device),
-                 request->udisks_device);
-  probe_request_free (request);
-  return FALSE; /* remove source */
+  UDisksLinuxProvider *provider = UDISKS_LINUX_PROVIDER (user_data);
+  GQueue handled = G_QUEUE_INIT;
+  ProbeRequest *request;
+  guint n;
+
+  g_atomic_int_set (&provider->probed_request_idle_pending, 0);
+
+  udisks_daemon_util_freeze_flush ();
+  for (n = 0; n < PROBED_UEVENTS_BATCH_MAX; n++)
+    {
+      request = g_async_queue_try_pop (provider->probed_request_queue);
+      if (request == NULL)
+        break;
+      udisks_linux_provider_handle_uevent (provider,
+                                           g_udev_device_get_action (request->udev_device),
+                                           request->udisks_device);
+      g_queue_push_tail (&handled, request);
+    }
+  udisks_daemon_util_thaw_flush ();
+
+  /* only announce the uevents once the changes are on the bus, callers of
+   * udisks_daemon_util_trigger_uevent_sync() rely on that
+   */
+  while ((request = g_queue_pop_head (&handled)) != NULL)
+    {
+      g_signal_emit (provider,
+                     signals[UEVENT_PROBED_SIGNAL],
+                     0,
+                     g_udev_device_get_action (request->udev_device),
+                     request->udisks_device);
+      probe_request_free (request);
+    }
+
+  /* more work queued up while we were busy and nobody scheduled us yet */
+  if (g_async_queue_length (provider->probed_request_queue) > 0 &&
+      g_atomic_int_compare_and_exchange (&provider->probed_request_idle_pending, 0, 1))
+    return G_SOURCE_CONTINUE;
+
+  return G_SOURCE_REMOVE;
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
@@ -330,7 +400,12 @@ probe_request_thread_func (gpointer user_data)
       request->udisks_device = udisks_linux_device_new_sync (request->udev_device, provider->gudev_client);
 
       /* now that we've probed the device, post the request back to the main thread */
-      g_idle_add (on_idle_with_probed_uevent, request);
+      g_async_queue_push (provider->probed_request_queue, request);
+      if (g_atomic_int_compare_and_exchange (&provider->probed_request_idle_pending, 0, 1))
+        g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+                         on_idle_with_probed_uevents,
+                         g_object_ref (provider),
+                         g_object_unref);
     }
   while (TRUE);
 
@@ -412,6 +487,7 @@ udisks_linux_provider_constructed (GObject *object)
   provider->gudev_client = g_udev_client_new (udev_subsystems);
 
   provider->probe_request_queue = g_async_queue_new ();
+  provider->probed_request_queue = g_async_queue_new_full ((GDestroyNotify) probe_request_free);
   provider->probe_request_thread = g_thread_new ("udisks-probing-thread",
                                                  probe_request_thread_func,
                                                  provider);
@@ -425,6 +501,7 @@ udisks_linux_provider_constructed (GObject *object)
   provider->mount_monitor = g_unix_mount_monitor_get ();
 
   provider->module_ifaces = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+  provider->coldplugged_modules = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 
   file = g_file_new_for_path (udisks_config_manager_get_config_dir (config_manager));
   provider->etc_udisks2_dir_monitor = g_file_monitor_directory (file,
@@ -449,28 +526,44 @@ udisks_linux_provider_constructed (GObject *object)
 }
 
 static void
-synthesize_uevent_for_id (UDisksLinuxProvider *provider,
-                          const gchar         *id,
-                          const gchar         *action)
+update_id_to_drive (UDisksLinuxProvider *provider)
 {
   GHashTableIter iter;
   UDisksLinuxDriveObject *drive_object;
 
-  /* TODO: could have a GHashTable from id to UDisksLinuxDriveObject */
-  g_hash_table_iter_init (&iter, provider->sysfs_path_to_drive);
+  if (!provider->id_to_drive_dirty)
+    return;
+
+  g_hash_table_remove_all (provider->id_to_drive);
+  g_hash_table_iter_init (&iter, provider->vpd_to_drive);
   while (g_hash_table_iter_next (&iter, NULL, (gpointer*) &drive_object))
     {
       UDisksDrive *drive = udisks_object_get_drive (UDISKS_OBJECT (drive_object));
       if (drive != NULL)
         {
-          if (g_strcmp0 (udisks_drive_get_id (drive), id) == 0)
-            {
-              udisks_debug ("synthesizing %s event on drive with id %s", action, id);
-              udisks_linux_drive_object_uevent (drive_object, action, NULL);
-            }
+          const gchar *id = udisks_drive_get_id (drive);
+          if (id != NULL && strlen (id) > 0)
+            g_hash_table_insert (provider->id_to_drive, g_strdup (id), drive_object);
           g_object_unref (drive);
         }
     }
+  provider->id_to_drive_dirty = FALSE;
+}
+
+static void
+synthesize_uevent_for_id (UDisksLinuxProvider *provider,
+                          const gchar         *id,
+                          const gchar         *action)
+{
+  UDisksLinuxDriveObject *drive_object;
+
+  update_id_to_drive (provider);
+  drive_object = g_hash_table_lookup (provider->id_to_drive, id);
+  if (drive_object != NULL)
+    {
+      udisks_debug ("synthesizing %s event on drive with id %s", action, id);
+      udisks_linux_drive_object_uevent (drive_object, action, NULL);
+    }
 }
 
 static gchar *
@@ -600,6 +693,59 @@ detach_module_interfaces (UDisksLinuxProvider *provider)
   g_hash_table_remove_all (provider->module_ifaces);
 }
 
+static gint
+block_object_name_cmp (UDisksLinuxBlockObject *a,
+                       UDisksLinuxBlockObject *b)
+{
+  UDisksLinuxDevice *device_a = udisks_linux_block_object_get_device (a);
+  UDisksLinuxDevice *device_b = udisks_linux_block_object_get_device (b);
+  gint ret;
+
+  ret = udev_device_name_cmp (device_a->udev_device, device_b->udev_device);
+  g_object_unref (device_a);
+  g_object_unref (device_b);
+  return ret;
+}
+
+/* Lets @modules pick up existing objects, like do_coldplug() does for all
+ * modules but without reprocessing the core interfaces of every object.
+ */
+static void
+coldplug_modules (UDisksLinuxProvider *provider,
+                  GList               *modules)
+{
+  GList *objects;
+  GList *l;
+
+  G_LOCK (provider_lock);
+
+  /* same order as in handle_block_uevent(): module objects, drives, blocks */
+  objects = g_hash_table_get_values (provider->sysfs_to_block);
+  objects = g_list_sort (objects, (GCompareFunc) block_object_name_cmp);
+  for (l = objects; l != NULL; l = l->next)
+    {
+      UDisksLinuxDevice *device = udisks_linux_block_object_get_device (l->data);
+      if (!g_udev_device_get_property_as_boolean (device->udev_device, "DM_UDEV_DISABLE_OTHER_RULES_FLAG"))
+        handle_block_uevent_for_module_list (provider, "add", device, modules);
+      g_object_unref (device);
+    }
+
+  {
+    GList *drives;
+
+    drives = g_hash_table_get_values (provider->vpd_to_drive);
+    for (l = drives; l != NULL; l = l->next)
+      udisks_linux_drive_object_coldplug_modules (l->data, modules);
+    g_list_free (drives);
+  }
+
+  for (l = objects; l != NULL; l = l->next)
+    udisks_linux_block_object_coldplug_modules (l->data, modules);
+  g_list_free (objects);
+
+  G_UNLOCK (provider_lock);
+}
+
 static void
 ensure_modules (UDisksLinuxProvider *provider)
 {
@@ -615,6 +761,7 @@ ensure_modules (UDisksLinuxProvider *provider)
 
   if (modules)
     {
+      GList *new_modules = NULL;
       GList *l;
 
       /* Attach additional interfaces from modules. */
@@ -635,16 +782,28 @@ ensure_modules (UDisksLinuxProvider *provider)
                   g_hash_table_replace (provider->module_ifaces, g_strdup (udisks_module_get_name (module)), iface);
                 }
             }
+
+          if (g_hash_table_add (provider->coldplugged_modules, g_strdup (udisks_module_get_name (module))))
+            new_modules = g_list_append (new_modules, module);
         }
+
+      /* Only the newly activated modules need to see the existing objects */
+      if (new_modules != NULL)
+        {
+          udisks_debug ("Performing coldplug for %u new module(s)...", g_list_length (new_modules));
+          coldplug_modules (provider, new_modules);
+          udisks_debug ("Coldplug complete");
+        }
+      g_list_free (new_modules);
       g_list_free_full (modules, g_object_unref);
-    }
-  else
-    {
-      /* Detach additional interfaces from modules. */
-      udisks_debug ("Modules unloading, detaching interfaces...");
-      detach_module_interfaces (provider);
+      return;
     }
 
+  /* Detach additional interfaces from modules. */
+  udisks_debug ("Modules unloading, detaching interfaces...");
+  detach_module_interfaces (provider);
+  g_hash_table_remove_all (provider->coldplugged_modules);
+
   /* Perform coldplug */
   udisks_debug ("Performing coldplug...");
   udisks_devices = get_udisks_devices (provider);
@@ -748,6 +907,11 @@ udisks_linux_provider_start (UDisksProvider *_provider)
                                                          g_str_equal,
                                                          g_free,
                                                          NULL);
+  provider->id_to_drive = g_hash_table_new_full (g_str_hash,
+                                                 g_str_equal,
+                                                 g_free,
+                                                 NULL);
+  provider->id_to_drive_dirty = TRUE;
   provider->uuid_to_mdraid = g_hash_table_new_full (g_str_hash,
                                                     g_str_equal,
                                                     g_free,
@@ -764,6 +928,22 @@ udisks_linux_provider_start (UDisksProvider *_provider)
                                                     g_direct_equal,
                                                     NULL,
                                                     (GDestroyNotify) g_hash_table_unref);
+  provider->module_object_claims = g_hash_table_new_full (g_str_hash,
+                                                          g_str_equal,
+                                                          g_free,
+                                                          (GDestroyNotify) g_hash_table_unref);
+  provider->module_object_to_claims = g_hash_table_new_full (g_direct_hash,
+                                                             g_direct_equal,
+                                                             NULL,
+                                                             (GDestroyNotify) g_strfreev);
+  provider->module_object_claim_properties = g_hash_table_new_full (g_str_hash,
+                                                                    g_str_equal,
+                                                                    g_free,
+                                                                    NULL);
+  provider->module_objects_unclaimed = g_hash_table_new_full (g_direct_hash,
+                                                              g_direct_equal,
+                                                              NULL,
+                                                              (GDestroyNotify) g_hash_table_unref);
 
   daemon = udisks_provider_get_daemon (UDISKS_PROVIDER (provider));
 
@@ -794,6 +974,17 @@ udisks_linux_provider_start (UDisksProvider *_provider)
   g_list_free_full (udisks_devices, g_object_unref);
   udisks_info ("Initialization complete");
 
+  /* modules activated before this point have already seen all objects */
+  {
+    GList *modules;
+    GList *l;
+
+    modules = udisks_module_manager_get_modules (module_manager);
+    for (l = modules; l != NULL; l = l->next)
+      g_hash_table_add (provider->coldplugged_modules, g_strdup (udisks_module_get_name (l->data)));
+    g_list_free_full (modules, g_object_unref);
+  }
+
   /* schedule housekeeping for every 10 minutes */
   provider->housekeeping_timeout = g_timeout_add_seconds (10*60,
                                                           on_housekeeping_timeout,
@@ -1110,6 +1301,9 @@ handle_block_uevent_for_drive (UDisksLinuxProvider *provider,
   daemon = udisks_provider_get_daemon (UDISKS_PROVIDER (provider));
   sysfs_path = g_udev_device_get_sysfs_path (device->udev_device);
 
+  /* drives may come and go or change their Id on any uevent */
+  provider->id_to_drive_dirty = TRUE;
+
   if (g_strcmp0 (action, "remove") == 0)
     {
       object = g_hash_table_lookup (provider->sysfs_path_to_drive, sysfs_path);
@@ -1175,8 +1369,8 @@ handle_block_uevent_for_drive (UDisksLinuxProvider *provider,
             }
           else
             {
-              udisks_critical ("Couldn't find existing drive object for device %s (uevent action '%s', VPD '%s')",
-                               sysfs_path, action, vpd);
+              udisks_critical_ratelimited ("Couldn't find existing drive object for device %s (uevent action '%s', VPD '%s')",
+                                           sysfs_path, action, vpd);
             }
         }
     }
@@ -1279,16 +1473,222 @@ handle_block_uevent_for_block (UDisksLinuxProvider *provider,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+/* returns the udev property name of a udisks_module_object_claim_udev_property() claim */
+static gchar *
+claim_dup_property_name (const gchar *claim)
+{
+  if (!g_str_has_prefix (claim, "property:"))
+    return NULL;
+  claim += strlen ("property:");
+  return g_strndup (claim, strcspn (claim, "="));
+}
+
 /* called with lock held */
 static void
-handle_block_uevent_for_modules (UDisksLinuxProvider *provider,
-                                 const gchar         *action,
-                                 UDisksLinuxDevice   *device)
+module_object_unregister_claims (UDisksLinuxProvider *provider,
+                                 GDBusObjectSkeleton *object)
+{
+  gchar **claims;
+  gchar **c;
+  gchar *name;
+
+  claims = g_hash_table_lookup (provider->module_object_to_claims, object);
+  for (c = claims; c && *c; c++)
+    {
+      GHashTable *claimers;
+
+      claimers = g_hash_table_lookup (provider->module_object_claims, *c);
+      if (claimers == NULL || !g_hash_table_remove (claimers, object))
+        continue;
+      if (g_hash_table_size (claimers) == 0)
+        g_hash_table_remove (provider->module_object_claims, *c);
+
+      name = claim_dup_property_name (*c);
+      if (name != NULL)
+        {
+          guint count;
+
+          count = GPOINTER_TO_UINT (g_hash_table_lookup (provider->module_object_claim_properties, name));
+          if (count <= 1)
+            g_hash_table_remove (provider->module_object_claim_properties, name);
+          else
+            g_hash_table_insert (provider->module_object_claim_properties, g_strdup (name), GUINT_TO_POINTER (count - 1));
+          g_free (name);
+        }
+    }
+  g_hash_table_remove (provider->module_object_to_claims, object);
+}
+
+/* called with lock held */
+static void
+module_object_update_claims (UDisksLinuxProvider *provider,
+                             GDBusObjectSkeleton *object)
+{
+  gchar **claims;
+  gchar **c;
+  gchar *name;
+
+  module_object_unregister_claims (provider, object);
+
+  claims = udisks_module_object_get_claims (UDISKS_MODULE_OBJECT (object));
+  if (claims == NULL)
+    return;
+
+  for (c = claims; *c; c++)
+    {
+      GHashTable *claimers;
+
+      claimers = g_hash_table_lookup (provider->module_object_claims, *c);
+      if (claimers == NULL)
+        {
+          claimers = g_hash_table_new (g_direct_hash, g_direct_equal);
+          g_hash_table_insert (provider->module_object_claims, g_strdup (*c), claimers);
+        }
+      if (!g_hash_table_add (claimers, object))
+        continue; /* listed twice */
+
+      name = claim_dup_property_name (*c);
+      if (name != NULL)
+        {
+          guint count;
+
+          count = GPOINTER_TO_UINT (g_hash_table_lookup (provider->module_object_claim_properties, name));
+          g_hash_table_insert (provider->module_object_claim_properties, name, GUINT_TO_POINTER (count + 1));
+        }
+    }
+  g_hash_table_insert (provider->module_object_to_claims, object, claims);
+}
+
+/* called with lock held */
+static void
+module_object_register (UDisksLinuxProvider *provider,
+                        UDisksModule        *module,
+                        GDBusObjectSkeleton *object)
+{
+  GHashTable *unclaimed;
+
+  if (udisks_module_object_has_claims (UDISKS_MODULE_OBJECT (object)))
+    {
+      module_object_update_claims (provider, object);
+    }
+  else
+    {
+      unclaimed = g_hash_table_lookup (provider->module_objects_unclaimed, module);
+      if (unclaimed == NULL)
+        {
+          unclaimed = g_hash_table_new (g_direct_hash, g_direct_equal);
+          g_hash_table_insert (provider->module_objects_unclaimed, module, unclaimed);
+        }
+      g_hash_table_add (unclaimed, object);
+    }
+}
+
+/* called with lock held */
+static void
+module_object_unregister (UDisksLinuxProvider *provider,
+                          UDisksModule        *module,
+                          GDBusObjectSkeleton *object)
+{
+  GHashTable *unclaimed;
+
+  module_object_unregister_claims (provider, object);
+
+  unclaimed = g_hash_table_lookup (provider->module_objects_unclaimed, module);
+  if (unclaimed != NULL && g_hash_table_remove (unclaimed, object) && g_hash_table_size (unclaimed) == 0)
+    g_hash_table_remove (provider->module_objects_unclaimed, module);
+}
+
+/* called with lock held */
+static void
+add_claimers (UDisksLinuxProvider *provider,
+              const gchar         *claim,
+              GHashTable          *result)
+{
+  GHashTable *claimers;
+  GHashTableIter iter;
+  gpointer object;
+
+  claimers = g_hash_table_lookup (provider->module_object_claims, claim);
+  if (claimers == NULL)
+    return;
+
+  g_hash_table_iter_init (&iter, claimers);
+  while (g_hash_table_iter_next (&iter, &object, NULL))
+    g_hash_table_add (result, object);
+}
+
+/* called with lock held
+ *
+ * Returns a set of module objects claiming @device, either by its sysfs path (or
+ * a parent of it), by its device number or by one of its udev properties.
+ */
+static GHashTable *
+find_claiming_module_objects (UDisksLinuxProvider *provider,
+                              UDisksLinuxDevice   *device)
+{
+  GHashTable *result;
+  const gchar *sysfs_path;
+  GHashTableIter iter;
+  const gchar *name;
+  gchar *claim;
+
+  result = g_hash_table_new (g_direct_hash, g_direct_equal);
+  if (g_hash_table_size (provider->module_object_claims) == 0)
+    return result;
+
+  /* walk up the sysfs hierarchy */
+  sysfs_path = g_udev_device_get_sysfs_path (device->udev_device);
+  if (sysfs_path != NULL)
+    {
+      GString *str;
+      gchar *slash;
+
+      str = g_string_new ("sysfs:");
+      g_string_append (str, sysfs_path);
+      while (str->len > strlen ("sysfs:") + 1)
+        {
+          add_claimers (provider, str->str, result);
+          slash = strrchr (str->str, '/');
+          if (slash == NULL)
+            break;
+          g_string_truncate (str, slash - str->str);
+        }
+      g_string_free (str, TRUE);
+    }
+
+  if (g_udev_device_get_device_number (device->udev_device) != 0)
+    {
+      claim = udisks_module_object_claim_device_number (g_udev_device_get_device_number (device->udev_device));
+      add_claimers (provider, claim, result);
+      g_free (claim);
+    }
+
+  g_hash_table_iter_init (&iter, provider->module_object_claim_properties);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &name, NULL))
+    {
+      const gchar *value;
+
+      value = g_udev_device_get_property (device->udev_device, name);
+      if (value == NULL)
+        continue;
+      claim = udisks_module_object_claim_udev_property (name, value);
+      add_claimers (provider, claim, result);
+      g_free (claim);
+    }
+
+  return result;
+}
+
+/* called with lock held */
+static void
+handle_block_uevent_for_module_list (UDisksLinuxProvider *provider,
+                                     const gchar         *action,
+                                     UDisksLinuxDevice   *device,
+                                     GList               *modules)
 {
   GDBusObjectSkeleton *object;
   UDisksDaemon *daemon;
-  UDisksModuleManager *module_manager;
-  GList *modules;
+  GHashTable *claiming;
   GList *l;
   GList *modules_to_remove = NULL;
 
@@ -1297,7 +1697,6 @@ handle_block_uevent_for_modules (UDisksLinuxProvider *provider,
     return;
 
   daemon = udisks_provider_get_daemon (UDISKS_PROVIDER (provider));
-  module_manager = udisks_daemon_get_module_manager (daemon);
 
   /* The object hierarchy is as follows:
    *
@@ -1312,8 +1711,13 @@ handle_block_uevent_for_modules (UDisksLinuxProvider *provider,
    *  - every instance can claim one or more devices
    *  - existing instances are asked first and only when none is interested in claiming the device
    *    a new instance for the current UDisksModule is attempted to be created
+   *
+   * Only instances that claim the device (see udisks_module_object_get_claims()) and instances
+   * not supporting claims at all are asked, so that the cost of routing a uevent doesn't grow
+   * with the number of module objects.
    */
-  modules = udisks_module_manager_get_modules (module_manager);
+  claiming = find_claiming_module_objects (provider, device);
+
   for (l = modules; l; l = l->next)
     {
       UDisksModule *module = l->data;
@@ -1324,13 +1728,30 @@ handle_block_uevent_for_modules (UDisksLinuxProvider *provider,
       inst_table = g_hash_table_lookup (provider->module_objects, module);
       if (inst_table)
         {
+          GList *candidates = NULL;
+          GList *ll;
+          GHashTable *unclaimed;
           GHashTableIter iter;
 
-          /* First try existing objects and ask them to process the uevent. */
-          g_hash_table_iter_init (&iter, inst_table);
+          g_hash_table_iter_init (&iter, claiming);
           while (g_hash_table_iter_next (&iter, (gpointer *) &object, NULL))
+            if (g_hash_table_contains (inst_table, object))
+              candidates = g_list_prepend (candidates, object);
+
+          unclaimed = g_hash_table_lookup (provider->module_objects_unclaimed, module);
+          if (unclaimed != NULL)
+            {
+              g_hash_table_iter_init (&iter, unclaimed);
+              while (g_hash_table_iter_next (&iter, (gpointer *) &object, NULL))
+                candidates = g_list_prepend (candidates, object);
+            }
+
+          /* First try existing objects and ask them to process the uevent. */
+          for (ll = candidates; ll; ll = ll->next)
             {
               gboolean keep = TRUE;
+
+              object = ll->data;
               if (udisks_module_object_process_uevent (UDISKS_MODULE_OBJECT (object), action, device, &keep))
                 {
                   handled = TRUE;
@@ -1339,17 +1760,21 @@ handle_block_uevent_for_modules (UDisksLinuxProvider *provider,
                       /* Queue for removal. */
                       instances_to_remove = g_list_append (instances_to_remove, object);
                     }
+                  else if (udisks_module_object_has_claims (UDISKS_MODULE_OBJECT (object)))
+                    {
+                      module_object_update_claims (provider, object);
+                    }
                 }
             }
+          g_list_free (candidates);
 
           /* Batch remove instances to prevent uevent storm. */
           if (instances_to_remove != NULL)
             {
-              GList *ll;
-
               for (ll = instances_to_remove; ll; ll = ll->next)
                 {
                   object = ll->data;
+                  module_object_unregister (provider, module, object);
                   g_warn_if_fail (g_dbus_object_manager_server_unexport (udisks_daemon_get_object_manager (daemon),
                                                                          g_dbus_object_get_object_path (G_DBUS_OBJECT (object))));
                   g_warn_if_fail (g_hash_table_remove (inst_table, object));
@@ -1383,6 +1808,7 @@ handle_block_uevent_for_modules (UDisksLinuxProvider *provider,
                   g_hash_table_insert (provider->module_objects, module, inst_table);
                 }
               g_hash_table_add (inst_table, *ll);
+              module_object_register (provider, module, *ll);
             }
           g_free (objects);
         }
@@ -1402,6 +1828,21 @@ handle_block_uevent_for_modules (UDisksLinuxProvider *provider,
       g_list_free (modules_to_remove);
     }
 
+  g_hash_table_unref (claiming);
+}
+
+/* called with lock held */
+static void
+handle_block_uevent_for_modules (UDisksLinuxProvider *provider,
+                                 const gchar         *action,
+                                 UDisksLinuxDevice   *device)
+{
+  UDisksDaemon *daemon;
+  GList *modules;
+
+  daemon = udisks_provider_get_daemon (UDISKS_PROVIDER (provider));
+  modules = udisks_module_manager_get_modules (udisks_daemon_get_module_manager (daemon));
+  handle_block_uevent_for_module_list (provider, action, device, modules);
   g_list_free_full (modules, g_object_unref);
 }
 
@@ -1508,9 +1949,9 @@ housekeeping_all_drives (UDisksLinuxProvider *provider,
                                                    NULL, /* TODO: cancellable */
                                                    &error))
         {
-          udisks_warning ("Error performing housekeeping for drive %s: %s (%s, %d)",
-                          g_dbus_object_get_object_path (G_DBUS_OBJECT (object)),
-                          error->message, g_quark_to_string (error->domain), error->code);
+          udisks_warning_ratelimited ("Error performing housekeeping for drive %s: %s (%s, %d)",
+                                      g_dbus_object_get_object_path (G_DBUS_OBJECT (object)),
+                                      error->message, g_quark_to_string (error->domain), error->code);
           g_clear_error (&error);
         }
     }
@@ -1550,9 +1991,9 @@ housekeeping_all_modules (UDisksLinuxProvider *provider,
                                                NULL, /* TODO: cancellable */
                                                &error))
         {
-          udisks_warning ("Error performing housekeeping for module object %s: %s (%s, %d)",
-                          g_dbus_object_get_object_path (G_DBUS_OBJECT (object)),
-                          error->message, g_quark_to_string (error->domain), error->code);
+          udisks_warning_ratelimited ("Error performing housekeeping for module object %s: %s (%s, %d)",
+                                      g_dbus_object_get_object_path (G_DBUS_OBJECT (object)),
+                                      error->message, g_quark_to_string (error->domain), error->code);
           g_clear_error (&error);
         }
     }
@@ -23,6 +23,8 @@
 
 #include <sys/types.h>
 #include <sys/syscall.h>
+#include <string.h>
+#include <stdarg.h>
 
 #include "udiskslogging.h"
 
@@ -34,6 +36,108 @@
  * Logging routines.
  */
 
+#define UDISKS_LOG_MESSAGE_BUF_SIZE 512
+
+G_LOCK_DEFINE_STATIC (ratelimit_lock);
+
+/**
+ * udisks_log_level_enabled:
+ * @level: A #UDisksLogLevel.
+ *
+ * Checks whether messages of @level in the "udisks" log domain would be
+ * emitted at all. Debug and informational messages are dropped unless
+ * the domain is listed in the <literal>G_MESSAGES_DEBUG</literal>
+ * environment variable, which is what the <option>--debug</option>
+ * daemon option sets.
+ *
+ * Returns: %TRUE if messages of @level are emitted, %FALSE otherwise.
+ */
+gboolean
+udisks_log_level_enabled (UDisksLogLevel level)
+{
+#if GLIB_CHECK_VERSION(2, 72, 0)
+  return !g_log_writer_default_would_drop ((GLogLevelFlags) level, "udisks");
+#else
+  const gchar *domains;
+
+  if (((GLogLevelFlags) level & (G_LOG_LEVEL_DEBUG | G_LOG_LEVEL_INFO)) == 0)
+    return TRUE;
+
+  domains = g_getenv ("G_MESSAGES_DEBUG");
+  if (domains == NULL)
+    return FALSE;
+
+  return strcmp (domains, "all") == 0 || strstr (domains, "udisks") != NULL;
+#endif
+}
+
+static void
+udisks_log_valist (UDisksLogLevel  level,
+                   const gchar    *function,
+                   const gchar    *location,
+                   const gchar    *format,
+                   va_list         var_args)
+{
+  gchar buf[UDISKS_LOG_MESSAGE_BUF_SIZE];
+  gchar *message = buf;
+  gchar thread_id[16];
+  const gchar *line;
+  va_list args_copy;
+  gint len;
+
+  /* most messages fit into the stack buffer, only allocate for long ones */
+  va_copy (args_copy, var_args);
+  len = g_vsnprintf (buf, sizeof (buf), format, args_copy);
+  va_end (args_copy);
+  if (len < 0 || len >= (gint) sizeof (buf))
+    message = g_strdup_vprintf (format, var_args);
+
+  g_snprintf (thread_id, sizeof (thread_id), "%d", (gint) syscall (SYS_gettid));
+
+#if GLIB_CHECK_VERSION(2, 50, 0)
+  {
+    /* G_STRLOC is "file:line", split it into the CODE_FILE and CODE_LINE fields */
+    GLogField fields[] =
+      {
+        { "MESSAGE",     message,   -1 },
+        { "PRIORITY",    NULL,      -1 },
+        { "GLIB_DOMAIN", "udisks",  -1 },
+        { "THREAD_ID",   thread_id, -1 },
+        { "CODE_FUNC",   function,  -1 },
+        { "CODE_FILE",   location,  -1 },
+        { "CODE_LINE",   NULL,      -1 },
+      };
+    gsize n_fields = G_N_ELEMENTS (fields);
+
+    switch ((GLogLevelFlags) level)
+      {
+      case G_LOG_LEVEL_ERROR:    fields[1].value = "3"; break;
+      case G_LOG_LEVEL_CRITICAL: fields[1].value = "4"; break;
+      case G_LOG_LEVEL_WARNING:  fields[1].value = "4"; break;
+      case G_LOG_LEVEL_MESSAGE:  fields[1].value = "5"; break;
+      case G_LOG_LEVEL_INFO:     fields[1].value = "6"; break;
+      default:                   fields[1].value = "7"; break;
+      }
+
+    line = location != NULL ? strrchr (location, ':') : NULL;
+    if (line != NULL)
+      {
+        fields[5].length = line - location;
+        fields[6].value = line + 1;
+      }
+    else
+      n_fields--;
+
+    g_log_structured_array ((GLogLevelFlags) level, fields, n_fields);
+  }
+#else
+  g_log ("udisks", level, "[%s]: %s [%s, %s()]", thread_id, message, location, function);
+#endif
+
+  if (message != buf)
+    g_free (message);
+}
+
 /**
  * udisks_log:
  * @level: A #UDisksLogLevel.
@@ -43,6 +147,9 @@
  * @...: Arguments for format.
  *
  * Low-level logging function used by udisks_debug() and other macros.
+ *
+ * The message is only formatted if @level is enabled, see
+ * udisks_log_level_enabled().
  */
 void
 udisks_log (UDisksLogLevel     level,
@@ -52,23 +159,67 @@ udisks_log (UDisksLogLevel     level,
             ...)
 {
   va_list var_args;
-  gchar *message;
-  gchar *thread_id;
+
+  if (!udisks_log_level_enabled (level))
+    return;
 
   va_start (var_args, format);
-  message = g_strdup_vprintf (format, var_args);
+  udisks_log_valist (level, function, location, format, var_args);
   va_end (var_args);
+}
 
-#if GLIB_CHECK_VERSION(2, 50, 0)
-  thread_id = g_strdup_printf ("%d", (gint) syscall (SYS_gettid));
-  g_log_structured ("udisks", (GLogLevelFlags) level,
-                    "THREAD_ID", thread_id,
-                    "CODE_FUNC", function, "CODE_FILE", location,
-                    "MESSAGE", "%s", message);
-  g_free (thread_id);
-#else
-  g_log ("udisks", level, "[%d]: %s [%s, %s()]", (gint) syscall (SYS_gettid), message, location, function);
-#endif
+/**
+ * udisks_log_ratelimited:
+ * @ratelimit: The per call site #UDisksLogRatelimit state.
+ * @level: A #UDisksLogLevel.
+ * @function: Pass #G_STRFUNC here.
+ * @location: Pass #G_STRLOC here.
+ * @format: printf()-style format.
+ * @...: Arguments for format.
+ *
+ * Like udisks_log() but emits at most %UDISKS_LOG_RATELIMIT_BURST messages
+ * per %UDISKS_LOG_RATELIMIT_INTERVAL for the call site owning @ratelimit.
+ * The number of suppressed messages is logged once the next message gets
+ * through. Used by udisks_warning_ratelimited() and similar macros.
+ */
+void
+udisks_log_ratelimited (UDisksLogRatelimit *ratelimit,
+                        UDisksLogLevel      level,
+                        const gchar        *function,
+                        const gchar        *location,
+                        const gchar        *format,
+                        ...)
+{
+  va_list var_args;
+  gint64 now;
+  guint suppressed = 0;
 
-  g_free (message);
+  if (!udisks_log_level_enabled (level))
+    return;
+
+  now = g_get_monotonic_time ();
+
+  G_LOCK (ratelimit_lock);
+  if (ratelimit->begin == 0 || now - ratelimit->begin >= UDISKS_LOG_RATELIMIT_INTERVAL)
+    {
+      suppressed = ratelimit->suppressed;
+      ratelimit->begin = now;
+      ratelimit->num = 0;
+      ratelimit->suppressed = 0;
+    }
+  if (ratelimit->num >= UDISKS_LOG_RATELIMIT_BURST)
+    {
+      ratelimit->suppressed++;
+      G_UNLOCK (ratelimit_lock);
+      return;
+    }
+  ratelimit->num++;
+  G_UNLOCK (ratelimit_lock);
+
+  if (suppressed > 0)
+    udisks_log (level, function, location, "Suppressed %u similar messages", suppressed);
+
+  va_start (var_args, format);
+  udisks_log_valist (level, function, location, format, var_args);
+  va_end (var_args);
 }
@@ -26,12 +26,55 @@
 
 G_BEGIN_DECLS
 
+/**
+ * UDISKS_LOG_RATELIMIT_INTERVAL:
+ *
+ * Length of the rate limiting interval in microseconds, see udisks_log_ratelimited().
+ */
+#define UDISKS_LOG_RATELIMIT_INTERVAL (30 * G_USEC_PER_SEC)
+
+/**
+ * UDISKS_LOG_RATELIMIT_BURST:
+ *
+ * Number of messages a call site may emit per %UDISKS_LOG_RATELIMIT_INTERVAL.
+ */
+#define UDISKS_LOG_RATELIMIT_BURST 5
+
+/**
+ * UDisksLogRatelimit:
+ *
+ * Per call site state used by udisks_log_ratelimited(). Must be zero-initialized.
+ */
+typedef struct
+{
+  /*< private >*/
+  gint64 begin;
+  guint  num;
+  guint  suppressed;
+} UDisksLogRatelimit;
+
+gboolean udisks_log_level_enabled (UDisksLogLevel level);
+
 void udisks_log (UDisksLogLevel   level,
                  const gchar     *function,
                  const gchar     *location,
                  const gchar     *format,
                  ...) G_GNUC_PRINTF (4, 5);
 
+void udisks_log_ratelimited (UDisksLogRatelimit *ratelimit,
+                             UDisksLogLevel      level,
+                             const gchar        *function,
+                             const gchar        *location,
+                             const gchar        *format,
+                             ...) G_GNUC_PRINTF (5, 6);
+
+/* private, use udisks_warning_ratelimited() and friends; each call site gets its own state */
+#define _udisks_log_ratelimited(level, args...) \
+  G_STMT_START { \
+    static UDisksLogRatelimit _udisks_log_ratelimit = { 0, }; \
+    udisks_log_ratelimited (&_udisks_log_ratelimit, level, G_STRFUNC, G_STRLOC, args); \
+  } G_STMT_END
+
 /**
  * udisks_debug:
  * @args...: printf()-style format string and arguments
@@ -113,6 +156,28 @@ void udisks_log (UDisksLogLevel   level,
  */
 #define udisks_error(args...)   udisks_log(UDISKS_LOG_LEVEL_ERROR, G_STRFUNC, G_STRLOC, args)
 
+/**
+ * udisks_warning_ratelimited:
+ * @args...: printf()-style format string and arguments
+ *
+ * Like udisks_warning() but logs at most %UDISKS_LOG_RATELIMIT_BURST
+ * messages per %UDISKS_LOG_RATELIMIT_INTERVAL from the same call site.
+ *
+ * See udisks_log_ratelimited() for more details.
+ */
+#define udisks_warning_ratelimited(args...)  _udisks_log_ratelimited(UDISKS_LOG_LEVEL_WARNING, args)
+
+/**
+ * udisks_critical_ratelimited:
+ * @args...: printf()-style format string and arguments
+ *
+ * Like udisks_critical() but logs at most %UDISKS_LOG_RATELIMIT_BURST
+ * messages per %UDISKS_LOG_RATELIMIT_INTERVAL from the same call site.
+ *
+ * See udisks_log_ratelimited() for more details.
+ */
+#define udisks_critical_ratelimited(args...) _udisks_log_ratelimited(UDISKS_LOG_LEVEL_CRITICAL, args)
+
 
 G_END_DECLS
 
@@ -390,8 +390,10 @@ udisks_module_new_manager (UDisksModule *module)
  * The uevent routing works as follows:
  *   1. Existing module objects are asked first to process the uevent for a particular
  *      @device via the udisks_module_object_process_uevent() method on the
- *      #UDisksModuleObject interface. The method return value and the @keep argument
- *      control the claim:
+ *      #UDisksModuleObject interface. Objects implementing
+ *      udisks_module_object_get_claims() are only asked when one of their claims
+ *      matches the @device, other objects are asked for every uevent.
+ *      The method return value and the @keep argument control the claim:
  *        * method return value of %FALSE means the object doesn't currently hold
  *          the claim of the @device and is not interested of making new one. The
  *          return value of @keep is ignored in this case.
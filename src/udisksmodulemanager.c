@@ -281,19 +281,24 @@ have_module (UDisksModuleManager *manager,
   return FALSE;
 }
 
+/* Opens the module at @sopath and resolves its entry points. Returns %TRUE
+ * with @out_module_id set to %NULL if a module with the same name has already
+ * been loaded.
+ */
 static gboolean
-load_single_module_unlocked (UDisksModuleManager *manager,
-                             const gchar         *sopath,
-                             gboolean            *do_notify,
-                             GError             **error)
+open_module_unlocked (UDisksModuleManager  *manager,
+                      const gchar          *sopath,
+                      gchar               **out_module_id,
+                      UDisksModuleNewFunc  *out_module_new_func,
+                      GError              **error)
 {
-  UDisksState *state;
   GModule *handle;
   gchar *module_id;
   gchar *module_new_func_name;
   UDisksModuleIDFunc module_id_func;
   UDisksModuleNewFunc module_new_func;
-  UDisksModule *module;
+
+  *out_module_id = NULL;
 
   handle = g_module_open (sopath, 0);
   if (handle == NULL)
@@ -341,33 +346,89 @@ load_single_module_unlocked (UDisksModuleManager *manager,
    */
   g_module_make_resident (handle);
 
+  *out_module_id = module_id;
+  *out_module_new_func = module_new_func;
+  return TRUE;
+}
+
+static UDisksModule *
+init_module (UDisksModuleManager *manager,
+             UDisksModuleNewFunc  module_new_func,
+             GError             **error)
+{
+  UDisksModule *module;
+
   module = module_new_func (manager->daemon,
                             NULL /* cancellable */,
                             error);
-  if (module == NULL)
-    {
-      /* Workaround for broken modules to avoid segfault */
-      if (error == NULL)
-        {
-          g_set_error_literal (error, UDISKS_ERROR, UDISKS_ERROR_FAILED,
-                               "unknown fatal error");
-        }
-      g_free (module_id);
-      g_module_close (handle);
-      return FALSE;
-    }
+  /* Workaround for broken modules to avoid segfault */
+  if (module == NULL && error != NULL && *error == NULL)
+    g_set_error_literal (error, UDISKS_ERROR, UDISKS_ERROR_FAILED,
+                         "unknown fatal error");
+  return module;
+}
+
+static void
+add_module_unlocked (UDisksModuleManager *manager,
+                     UDisksModule        *module,
+                     const gchar         *module_id)
+{
+  UDisksState *state;
 
   manager->modules = g_list_append (manager->modules, module);
 
   state = udisks_daemon_get_state (manager->daemon);
   udisks_state_add_module (state, module_id);
+}
+
+static gboolean
+load_single_module_unlocked (UDisksModuleManager *manager,
+                             const gchar         *sopath,
+                             gboolean            *do_notify,
+                             GError             **error)
+{
+  gchar *module_id;
+  UDisksModuleNewFunc module_new_func;
+  UDisksModule *module;
+
+  if (! open_module_unlocked (manager, sopath, &module_id, &module_new_func, error))
+    return FALSE;
+  if (module_id == NULL)
+    return TRUE;
 
+  module = init_module (manager, module_new_func, error);
+  if (module == NULL)
+    {
+      g_free (module_id);
+      return FALSE;
+    }
+
+  add_module_unlocked (manager, module, module_id);
   g_free (module_id);
 
   *do_notify = TRUE;
   return TRUE;
 }
 
+typedef struct
+{
+  UDisksModuleManager *manager;
+  gchar *module_id;
+  UDisksModuleNewFunc module_new_func;
+  GThread *thread;
+  UDisksModule *module;
+  GError *error;
+} ModuleInitData;
+
+static gpointer
+module_init_thread_func (gpointer user_data)
+{
+  ModuleInitData *data = user_data;
+
+  data->module = init_module (data->manager, data->module_new_func, &data->error);
+  return NULL;
+}
+
 /**
  * udisks_module_manager_load_single_module:
  * @manager: A #UDisksModuleManager instance.
@@ -424,38 +485,108 @@ udisks_module_manager_load_single_module (UDisksModuleManager *manager,
  *
  * Loads all modules at a time and emits the <literal>modules-activated</literal>
  * signal in case any new module has been activated. Modules that are already loaded
- * are skipped on subsequent calls to this method.
+ * are skipped on subsequent calls to this method. The modules are initialized
+ * concurrently, each in its own thread.
  */
 void
 udisks_module_manager_load_modules (UDisksModuleManager *manager)
 {
   GList *modules_to_load;
   GList *modules_to_load_tmp;
+  GPtrArray *pending;
   GError *error = NULL;
   gboolean do_notify = FALSE;
+  guint n;
 
   g_return_if_fail (UDISKS_IS_MODULE_MANAGER (manager));
 
   g_mutex_lock (&manager->modules_lock);
 
-  /* Load the modules */
+  /* Open the modules, this is cheap and needs to be serialized */
+  pending = g_ptr_array_new ();
   modules_to_load = get_modules_list (manager);
   for (modules_to_load_tmp = modules_to_load;
        modules_to_load_tmp;
        modules_to_load_tmp = modules_to_load_tmp->next)
     {
-
-      if (! load_single_module_unlocked (manager,
-                                         modules_to_load_tmp->data,
-                                         &do_notify,
-                                         &error))
+      ModuleInitData *data;
+      gchar *module_id;
+      UDisksModuleNewFunc module_new_func;
+
+      if (! open_module_unlocked (manager,
+                                  modules_to_load_tmp->data,
+                                  &module_id,
+                                  &module_new_func,
+                                  &error))
         {
           udisks_critical ("Error loading module: %s",
                            error->message);
           g_clear_error (&error);
           continue;
         }
+      if (module_id == NULL)
+        continue;
+
+      /* the same module may be present in the list twice */
+      for (n = 0; n < pending->len; n++)
+        if (g_strcmp0 (((ModuleInitData *) pending->pdata[n])->module_id, module_id) == 0)
+          break;
+      if (n < pending->len)
+        {
+          g_free (module_id);
+          continue;
+        }
+
+      data = g_new0 (ModuleInitData, 1);
+      data->manager = manager;
+      data->module_id = module_id;
+      data->module_new_func = module_new_func;
+      g_ptr_array_add (pending, data);
+    }
+
+  /* Initialize the modules concurrently as some of them spawn tools or
+   * connect to external services during initialization.
+   */
+  for (n = 0; n < pending->len; n++)
+    {
+      ModuleInitData *data = pending->pdata[n];
+      gchar *thread_name;
+
+      if (pending->len == 1)
+        {
+          module_init_thread_func (data);
+          continue;
+        }
+      thread_name = g_strdup_printf ("module-%s", data->module_id);
+      data->thread = g_thread_try_new (thread_name, module_init_thread_func, data, NULL);
+      g_free (thread_name);
+      if (data->thread == NULL)
+        module_init_thread_func (data);
+    }
+
+  /* Register the modules in the order they were found */
+  for (n = 0; n < pending->len; n++)
+    {
+      ModuleInitData *data = pending->pdata[n];
+
+      if (data->thread != NULL)
+        g_thread_join (data->thread);
+
+      if (data->module == NULL)
+        {
+          udisks_critical ("Error loading module: %s",
+                           data->error->message);
+          g_clear_error (&data->error);
+        }
+      else
+        {
+          add_module_unlocked (manager, data->module, data->module_id);
+          do_notify = TRUE;
+        }
+      g_free (data->module_id);
+      g_free (data);
     }
+  g_ptr_array_free (pending, TRUE);
 
   g_mutex_unlock (&manager->modules_lock);
 
@@ -19,6 +19,9 @@
  */
 
 #include <config.h>
+
+#include <sys/sysmacros.h>
+
 #include "udisksmoduleobject.h"
 
 
@@ -105,3 +108,107 @@ udisks_module_object_housekeeping (UDisksModuleObject  *object,
 {
   return UDISKS_MODULE_OBJECT_GET_IFACE (object)->housekeeping (object, secs_since_last, cancellable, error);
 }
+
+/**
+ * udisks_module_object_has_claims:
+ * @object: A #UDisksModuleObject.
+ *
+ * Checks whether @object declares the devices it owns, i.e. whether it
+ * implements udisks_module_object_get_claims().
+ *
+ * Returns: %TRUE if @object supports claims, %FALSE if it needs to be
+ *          offered every uevent.
+ *
+ * Since: 2.11.0
+ */
+gboolean
+udisks_module_object_has_claims (UDisksModuleObject *object)
+{
+  return UDISKS_MODULE_OBJECT_GET_IFACE (object)->get_claims != NULL;
+}
+
+/**
+ * udisks_module_object_get_claims:
+ * @object: A #UDisksModuleObject.
+ *
+ * A #UDisksModuleObject method that is called by #UDisksLinuxProvider to
+ * retrieve the list of devices @object owns. Uevents are only routed via
+ * udisks_module_object_process_uevent() to objects claiming the device
+ * and the respective udisks_module_new_object() is called only when no
+ * object of the module claims (and processes) the device.
+ *
+ * Claims are created by udisks_module_object_claim_sysfs_path(),
+ * udisks_module_object_claim_device_number() and
+ * udisks_module_object_claim_udev_property(). The list is retrieved again
+ * after each udisks_module_object_process_uevent() call that returned %TRUE
+ * so that @object may extend or shrink its claims as devices come and go.
+ *
+ * Objects not implementing this method are offered every uevent.
+ *
+ * Returns: (transfer full) (nullable) (array zero-terminated=1): A %NULL-terminated
+ *          list of claims or %NULL. Free with g_strfreev().
+ *
+ * Since: 2.11.0
+ */
+gchar **
+udisks_module_object_get_claims (UDisksModuleObject *object)
+{
+  UDisksModuleObjectIface *iface = UDISKS_MODULE_OBJECT_GET_IFACE (object);
+
+  if (iface->get_claims == NULL)
+    return NULL;
+  return iface->get_claims (object);
+}
+
+/**
+ * udisks_module_object_claim_sysfs_path:
+ * @sysfs_path: A sysfs path.
+ *
+ * Creates a claim for the device at @sysfs_path and all devices below it
+ * in the sysfs hierarchy, see udisks_module_object_get_claims().
+ *
+ * Returns: (transfer full): A claim. Free with g_free().
+ *
+ * Since: 2.11.0
+ */
+gchar *
+udisks_module_object_claim_sysfs_path (const gchar *sysfs_path)
+{
+  return g_strconcat ("sysfs:", sysfs_path, NULL);
+}
+
+/**
+ * udisks_module_object_claim_device_number:
+ * @device_number: A device number.
+ *
+ * Creates a claim for the device with @device_number, see
+ * udisks_module_object_get_claims().
+ *
+ * Returns: (transfer full): A claim. Free with g_free().
+ *
+ * Since: 2.11.0
+ */
+gchar *
+udisks_module_object_claim_device_number (dev_t device_number)
+{
+  return g_strdup_printf ("devnum:%u:%u", major (device_number), minor (device_number));
+}
+
+/**
+ * udisks_module_object_claim_udev_property:
+ * @name: Name of the udev property.
+ * @value: Value of the udev property.
+ *
+ * Creates a claim for all devices having the udev property @name set to
+ * @value, see udisks_module_object_get_claims().
+ *
+ * Returns: (transfer full): A claim. Free with g_free().
+ *
+ * Since: 2.11.0
+ */
+gchar *
+udisks_module_object_claim_udev_property (const gchar *name,
+                                          const gchar *value)
+{
+  return g_strdup_printf ("property:%s=%s", name, value);
+}
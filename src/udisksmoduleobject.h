@@ -21,6 +21,7 @@
 #ifndef __UDISKS_MODULE_OBJECT_H__
 #define __UDISKS_MODULE_OBJECT_H__
 
+#include <sys/types.h>
 #include <glib-object.h>
 #include <gio/gio.h>
 
@@ -48,6 +49,8 @@ typedef struct _UDisksModuleObjectIface    UDisksModuleObjectIface;
  * @parent_iface: The parent interface.
  * @process_uevent: Virtual function for udisks_module_object_process_uevent().
  * @housekeeping: Virtual function for udisks_module_object_housekeeping().
+ * @get_claims: Virtual function for udisks_module_object_get_claims(). Optional,
+ *              objects not implementing it are offered every uevent.
  *
  * Object interface structure for #UDisksModuleObject.
  */
@@ -64,6 +67,8 @@ struct _UDisksModuleObjectIface
                             guint                secs_since_last,
                             GCancellable        *cancellable,
                             GError             **error);
+
+  gchar ** (*get_claims) (UDisksModuleObject  *object);
 };
 
 GType udisks_module_object_get_type (void) G_GNUC_CONST;
@@ -78,6 +83,14 @@ gboolean udisks_module_object_housekeeping   (UDisksModuleObject  *object,
                                               GCancellable        *cancellable,
                                               GError             **error);
 
+gboolean udisks_module_object_has_claims     (UDisksModuleObject  *object);
+gchar  **udisks_module_object_get_claims     (UDisksModuleObject  *object);
+
+gchar   *udisks_module_object_claim_sysfs_path     (const gchar *sysfs_path);
+gchar   *udisks_module_object_claim_device_number  (dev_t        device_number);
+gchar   *udisks_module_object_claim_udev_property  (const gchar *name,
+                                                    const gchar *value);
+
 G_END_DECLS
 
 #endif /* __UDISKS_MODULE_OBJECT_H__ */
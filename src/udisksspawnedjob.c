@@ -18,6 +18,8 @@
  *
  */
 
+#define _GNU_SOURCE /* for posix_spawn_file_actions_addclosefrom_np() */
+
 #include "config.h"
 #include <glib/gi18n-lib.h>
 
@@ -29,12 +31,20 @@
 #include <pwd.h>
 #include <grp.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+
+#include <glib-unix.h>
+#include <gio/gunixinputstream.h>
 
 #include "udisksbasejob.h"
 #include "udisksspawnedjob.h"
 #include "udisks-daemon-marshal.h"
 #include "udisksdaemon.h"
 #include "udisksdaemonutil.h"
+#include "udiskslogging.h"
 
 /**
  * SECTION:udisksspawnedjob
@@ -47,6 +57,23 @@
 
 typedef struct _UDisksSpawnedJobClass   UDisksSpawnedJobClass;
 
+/* Number of bytes read from the child's output pipes at once */
+#define OUTPUT_READ_SIZE 65536
+
+/* seconds for which a looked up password record is reused */
+#define PASSWD_CACHE_TTL 60
+
+/* State for reading one of the output pipes of the child */
+typedef struct
+{
+  UDisksSpawnedJob *job;
+  GInputStream *stream;
+  GSource *source;
+  gboolean standard_error;
+  gsize line_start;
+  gboolean truncated;
+} ChildOutput;
+
 /**
  * UDisksSpawnedJob:
  *
@@ -58,6 +85,7 @@ struct _UDisksSpawnedJob
   UDisksBaseJob parent_instance;
 
   gchar *command_line;
+  gchar **argv;
   gulong cancellable_handler_id;
 
   GMainContext *main_context;
@@ -78,16 +106,21 @@ struct _UDisksSpawnedJob
   gint child_stderr_fd;
 
   GIOChannel *child_stdin_channel;
-  GIOChannel *child_stdout_channel;
-  GIOChannel *child_stderr_channel;
 
   GSource *child_watch_source;
   GSource *child_stdin_source;
-  GSource *child_stdout_source;
-  GSource *child_stderr_source;
+
+  ChildOutput child_stdout_reader;
+  ChildOutput child_stderr_reader;
 
   GString *child_stdout;
   GString *child_stderr;
+
+  gsize output_limit;
+
+  UDisksSpawnedJobLineFunc line_func;
+  gpointer line_func_user_data;
+  GDestroyNotify line_func_user_data_free;
 };
 
 struct _UDisksSpawnedJobClass
@@ -107,6 +140,7 @@ enum
 {
   PROP_0,
   PROP_COMMAND_LINE,
+  PROP_ARGV,
   PROP_INPUT_STRING,
   PROP_RUN_AS_UID,
   PROP_RUN_AS_EUID
@@ -147,10 +181,14 @@ udisks_spawned_job_finalize (GObject *object)
 
   udisks_spawned_job_release_resources (job);
 
+  if (job->line_func_user_data_free != NULL)
+    job->line_func_user_data_free (job->line_func_user_data);
+
   if (job->main_context != NULL)
     g_main_context_unref (job->main_context);
 
   g_free (job->command_line);
+  g_strfreev (job->argv);
 
   if (job->input_string != NULL)
     g_boxed_free (autowipe_buffer_get_type (), (gpointer) job->input_string);
@@ -194,6 +232,11 @@ udisks_spawned_job_set_property (GObject      *object,
       job->command_line = g_value_dup_string (value);
       break;
 
+    case PROP_ARGV:
+      g_assert (job->argv == NULL);
+      job->argv = g_value_dup_boxed (value);
+      break;
+
     case PROP_INPUT_STRING:
       g_assert (job->input_string == NULL);
       job->input_string = (GString*) g_value_dup_boxed (value);
@@ -217,6 +260,35 @@ udisks_spawned_job_set_property (GObject      *object,
     }
 }
 
+static void
+udisks_spawned_job_constructed (GObject *object)
+{
+  UDisksSpawnedJob *job = UDISKS_SPAWNED_JOB (object);
+
+  /* construct a command line for display purposes */
+  if (job->command_line == NULL && job->argv != NULL)
+    {
+      GString *str;
+      guint n;
+
+      str = g_string_new (NULL);
+      for (n = 0; job->argv[n] != NULL; n++)
+        {
+          gchar *quoted;
+
+          if (n > 0)
+            g_string_append_c (str, ' ');
+          quoted = g_shell_quote (job->argv[n]);
+          g_string_append (str, quoted);
+          g_free (quoted);
+        }
+      job->command_line = g_string_free (str, FALSE);
+    }
+
+  if (G_OBJECT_CLASS (udisks_spawned_job_parent_class)->constructed != NULL)
+    G_OBJECT_CLASS (udisks_spawned_job_parent_class)->constructed (object);
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 typedef struct
@@ -282,32 +354,125 @@ on_cancelled (GCancellable *cancellable,
   g_clear_error (&error);
 }
 
-static gboolean
-read_child_stderr (GIOChannel *channel,
-                   GIOCondition condition,
-                   gpointer user_data)
+/* passes complete lines in @data starting at @from to the line function */
+static void
+process_child_output_lines (UDisksSpawnedJob *job,
+                            ChildOutput      *output,
+                            GString          *data,
+                            gsize             from)
 {
-  UDisksSpawnedJob *job = UDISKS_SPAWNED_JOB (user_data);
-  gchar buf[1024];
-  gsize bytes_read = 0;
+  gsize n;
 
-  g_io_channel_read_chars (channel, buf, sizeof buf, &bytes_read, NULL);
-  g_string_append_len (job->child_stderr, buf, bytes_read);
-  return TRUE;
+  if (job->line_func == NULL)
+    {
+      output->line_start = data->len;
+      return;
+    }
+
+  for (n = from; n < data->len; n++)
+    {
+      gchar c = data->str[n];
+
+      if (c != '\n' && c != '\r')
+        continue;
+
+      /* '\r' is used for progress updates overwriting the same line */
+      if (n > output->line_start)
+        {
+          data->str[n] = '\0';
+          job->line_func (job, output->standard_error, data->str + output->line_start, job->line_func_user_data);
+          data->str[n] = c;
+        }
+      output->line_start = n + 1;
+    }
+}
+
+/* Reads what's available from the child's output pipe straight into the
+ * output buffer. Returns the number of bytes read, 0 on EOF or error and
+ * -1 if there's nothing to read right now.
+ */
+static gssize
+read_child_output (UDisksSpawnedJob *job,
+                   ChildOutput      *output)
+{
+  GString *data;
+  gsize old_len;
+  gsize to_read;
+  gssize num_read;
+  gchar discard[4096];
+  GError *error = NULL;
+
+  data = output->standard_error ? job->child_stderr : job->child_stdout;
+  old_len = data->len;
+
+  to_read = OUTPUT_READ_SIZE;
+  if (job->output_limit > 0)
+    to_read = MIN (to_read, job->output_limit - MIN (old_len, job->output_limit));
+
+  if (to_read == 0)
+    {
+      /* over the limit, keep draining the pipe so the child doesn't block */
+      if (!output->truncated)
+        {
+          udisks_warning ("Output of command-line `%s' exceeded %" G_GSIZE_FORMAT " bytes, discarding the rest",
+                          job->command_line, job->output_limit);
+          output->truncated = TRUE;
+        }
+      num_read = g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM (output->stream),
+                                                           discard, sizeof discard, NULL, &error);
+    }
+  else
+    {
+      /* read directly into the (exponentially growing) buffer */
+      g_string_set_size (data, old_len + to_read);
+      num_read = g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM (output->stream),
+                                                           data->str + old_len, to_read, NULL, &error);
+      g_string_set_size (data, old_len + MAX (num_read, 0));
+      if (num_read > 0)
+        process_child_output_lines (job, output, data, old_len);
+    }
+
+  if (num_read < 0)
+    {
+      num_read = g_error_matches (error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK) ? -1 : 0;
+      g_clear_error (&error);
+    }
+
+  return num_read;
+}
+
+/* reads everything left in the pipe, used once the child has exited */
+static void
+drain_child_output (UDisksSpawnedJob *job,
+                    ChildOutput      *output)
+{
+  GString *data;
+
+  if (output->stream == NULL)
+    return;
+
+  while (read_child_output (job, output) > 0)
+    ;
+
+  /* pass on the last line even if it isn't terminated */
+  data = output->standard_error ? job->child_stderr : job->child_stdout;
+  if (job->line_func != NULL && output->line_start < data->len && !output->truncated)
+    job->line_func (job, output->standard_error, data->str + output->line_start, job->line_func_user_data);
+  output->line_start = data->len;
 }
 
 static gboolean
-read_child_stdout (GIOChannel *channel,
-                   GIOCondition condition,
-                   gpointer user_data)
+on_child_output (GObject  *pollable_stream,
+                 gpointer  user_data)
 {
-  UDisksSpawnedJob *job = UDISKS_SPAWNED_JOB (user_data);
-  gchar buf[1024];
-  gsize bytes_read = 0;
+  ChildOutput *output = user_data;
 
-  g_io_channel_read_chars (channel, buf, sizeof buf, &bytes_read, NULL);
-  g_string_append_len (job->child_stdout, buf, bytes_read);
-  return TRUE;
+  if (read_child_output (output->job, output) != 0)
+    return G_SOURCE_CONTINUE;
+
+  /* EOF or error, the source is destroyed when we return */
+  output->source = NULL;
+  return G_SOURCE_REMOVE;
 }
 
 static gboolean
@@ -354,22 +519,10 @@ child_watch_cb (GPid     pid,
                 gpointer user_data)
 {
   UDisksSpawnedJob *job = UDISKS_SPAWNED_JOB (user_data);
-  gchar *buf;
-  gsize buf_size;
   gboolean ret;
 
-  buf_size = 0;
-  if (g_io_channel_read_to_end (job->child_stdout_channel, &buf, &buf_size, NULL) == G_IO_STATUS_NORMAL)
-    {
-      g_string_append_len (job->child_stdout, buf, buf_size);
-      g_free (buf);
-    }
-  buf_size = 0;
-  if (g_io_channel_read_to_end (job->child_stderr_channel, &buf, &buf_size, NULL) == G_IO_STATUS_NORMAL)
-    {
-      g_string_append_len (job->child_stderr, buf, buf_size);
-      g_free (buf);
-    }
+  drain_child_output (job, &job->child_stdout_reader);
+  drain_child_output (job, &job->child_stderr_reader);
 
   //g_debug ("helper(pid %5d): completed with exit code %d\n", job->child_pid, WEXITSTATUS (status));
 
@@ -442,6 +595,10 @@ udisks_spawned_job_init (UDisksSpawnedJob *job)
   job->child_stdin_fd = -1;
   job->child_stdout_fd = -1;
   job->child_stderr_fd = -1;
+  job->child_stdout_reader.job = job;
+  job->child_stderr_reader.job = job;
+  job->child_stderr_reader.standard_error = TRUE;
+  job->output_limit = UDISKS_SPAWNED_JOB_DEFAULT_OUTPUT_LIMIT;
 }
 
 static void
@@ -454,6 +611,7 @@ udisks_spawned_job_class_init (UDisksSpawnedJobClass *klass)
   gobject_class = G_OBJECT_CLASS (klass);
   gobject_class->finalize     = udisks_spawned_job_finalize;
   gobject_class->set_property = udisks_spawned_job_set_property;
+  gobject_class->constructed  = udisks_spawned_job_constructed;
   gobject_class->get_property = udisks_spawned_job_get_property;
 
   /**
@@ -472,6 +630,24 @@ udisks_spawned_job_class_init (UDisksSpawnedJobClass *klass)
                                                         G_PARAM_CONSTRUCT_ONLY |
                                                         G_PARAM_STATIC_STRINGS));
 
+  /**
+   * UDisksSpawnedJob:argv:
+   *
+   * The program and its arguments to run. If set, this is used instead
+   * of parsing #UDisksSpawnedJob:command-line.
+   *
+   * Since: 2.11.0
+   */
+  g_object_class_install_property (gobject_class,
+                                   PROP_ARGV,
+                                   g_param_spec_boxed ("argv",
+                                                       "Argument Vector",
+                                                       "The program and arguments to run",
+                                                       G_TYPE_STRV,
+                                                       G_PARAM_WRITABLE |
+                                                       G_PARAM_CONSTRUCT_ONLY |
+                                                       G_PARAM_STATIC_STRINGS));
+
   /**
    * UDisksSpawnedJob:input-string:
    *
@@ -607,6 +783,42 @@ udisks_spawned_job_new (const gchar  *command_line,
                                            NULL));
 }
 
+/**
+ * udisks_spawned_job_new_argv:
+ * @argv: (array zero-terminated=1): The program and its arguments to run.
+ * @input_string: A string to write to stdin of the spawned program or %NULL.
+ * @run_as_uid: The #uid_t to run the program as.
+ * @run_as_euid: The effective #uid_t to run the program as.
+ * @daemon: A #UDisksDaemon.
+ * @cancellable: A #GCancellable or %NULL.
+ *
+ * Like udisks_spawned_job_new() but takes an already split argument
+ * vector, avoiding the need to construct and parse a quoted command line.
+ *
+ * Returns: A new #UDisksSpawnedJob. Free with g_object_unref().
+ *
+ * Since: 2.11.0
+ */
+UDisksSpawnedJob *
+udisks_spawned_job_new_argv (const gchar * const *argv,
+                             GString             *input_string,
+                             uid_t                run_as_uid,
+                             uid_t                run_as_euid,
+                             UDisksDaemon        *daemon,
+                             GCancellable        *cancellable)
+{
+  g_return_val_if_fail (argv != NULL && argv[0] != NULL, NULL);
+  g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
+  return UDISKS_SPAWNED_JOB (g_object_new (UDISKS_TYPE_SPAWNED_JOB,
+                                           "argv", argv,
+                                           "input-string", input_string,
+                                           "run-as-uid", run_as_uid,
+                                           "run-as-euid", run_as_euid,
+                                           "daemon", daemon,
+                                           "cancellable", cancellable,
+                                           NULL));
+}
+
 /**
  * udisks_spawned_job_get_command_line:
  * @job: A #UDisksSpawnedJob.
@@ -622,6 +834,59 @@ udisks_spawned_job_get_command_line (UDisksSpawnedJob *job)
   return job->command_line;
 }
 
+/**
+ * udisks_spawned_job_set_line_func:
+ * @job: A #UDisksSpawnedJob.
+ * @func: (nullable): A #UDisksSpawnedJobLineFunc or %NULL.
+ * @user_data: User data to pass to @func.
+ * @user_data_free_func: (nullable): Function to free @user_data with or %NULL.
+ *
+ * Sets a function to be called for every line the spawned program writes
+ * to its standard output or standard error, e.g. to parse progress while
+ * the program is still running. Both newline and carriage return
+ * characters terminate a line. The last line is passed on even if it
+ * isn't terminated.
+ *
+ * Must be called before udisks_spawned_job_start(). @func is called in
+ * the same thread as the #UDisksSpawnedJob::spawned-job-completed signal
+ * is emitted.
+ */
+void
+udisks_spawned_job_set_line_func (UDisksSpawnedJob         *job,
+                                  UDisksSpawnedJobLineFunc  func,
+                                  gpointer                  user_data,
+                                  GDestroyNotify            user_data_free_func)
+{
+  g_return_if_fail (UDISKS_IS_SPAWNED_JOB (job));
+  g_return_if_fail (job->child_pid == 0);
+
+  if (job->line_func_user_data_free != NULL)
+    job->line_func_user_data_free (job->line_func_user_data);
+
+  job->line_func = func;
+  job->line_func_user_data = user_data;
+  job->line_func_user_data_free = user_data_free_func;
+}
+
+/**
+ * udisks_spawned_job_set_output_limit:
+ * @job: A #UDisksSpawnedJob.
+ * @limit: Maximum number of bytes or 0 for no limit.
+ *
+ * Sets the maximum number of bytes kept from each of the standard output
+ * and standard error of the spawned program. Anything beyond is read and
+ * discarded. The default is %UDISKS_SPAWNED_JOB_DEFAULT_OUTPUT_LIMIT.
+ *
+ * Must be called before udisks_spawned_job_start().
+ */
+void
+udisks_spawned_job_set_output_limit (UDisksSpawnedJob *job,
+                                     gsize             limit)
+{
+  g_return_if_fail (UDISKS_IS_SPAWNED_JOB (job));
+  job->output_limit = limit;
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 static void
@@ -834,32 +1099,24 @@ udisks_spawned_job_release_resources (UDisksSpawnedJob *job)
       g_io_channel_unref (job->child_stdin_channel);
       job->child_stdin_channel = NULL;
     }
-  if (job->child_stdout_channel != NULL)
-    {
-      g_io_channel_unref (job->child_stdout_channel);
-      job->child_stdout_channel = NULL;
-    }
-  if (job->child_stderr_channel != NULL)
-    {
-      g_io_channel_unref (job->child_stderr_channel);
-      job->child_stderr_channel = NULL;
-    }
 
   if (job->child_stdin_source != NULL)
     {
       g_source_destroy (job->child_stdin_source);
       job->child_stdin_source = NULL;
     }
-  if (job->child_stdout_source != NULL)
+  if (job->child_stdout_reader.source != NULL)
     {
-      g_source_destroy (job->child_stdout_source);
-      job->child_stdout_source = NULL;
+      g_source_destroy (job->child_stdout_reader.source);
+      job->child_stdout_reader.source = NULL;
     }
-  if (job->child_stderr_source != NULL)
+  if (job->child_stderr_reader.source != NULL)
     {
-      g_source_destroy (job->child_stderr_source);
-      job->child_stderr_source = NULL;
+      g_source_destroy (job->child_stderr_reader.source);
+      job->child_stderr_reader.source = NULL;
     }
+  g_clear_object (&job->child_stdout_reader.stream);
+  g_clear_object (&job->child_stderr_reader.stream);
 
   if (job->child_stdin_fd != -1)
     {
@@ -885,11 +1142,268 @@ udisks_spawned_job_release_resources (UDisksSpawnedJob *job)
 
   if (job->real_pwname != NULL)
     {
-      free (job->real_pwname);
+      g_free (job->real_pwname);
       job->real_pwname = NULL;
     }
 }
 
+typedef struct
+{
+  gid_t gid;
+  gchar *name;
+  gint64 timestamp;
+} PasswdCacheEntry;
+
+static void
+passwd_cache_entry_free (PasswdCacheEntry *entry)
+{
+  g_free (entry->name);
+  g_free (entry);
+}
+
+G_LOCK_DEFINE_STATIC (passwd_cache_lock);
+static GHashTable *passwd_cache = NULL;
+
+/* Looks up the primary group and name of @uid. Jobs running as a user are
+ * usually spawned in bursts for the same user so the records are cached
+ * for a short time rather than going through NSS for each of them.
+ */
+static gboolean
+lookup_passwd_cached (uid_t    uid,
+                      gid_t   *out_gid,
+                      gchar  **out_name,
+                      GError **error)
+{
+  PasswdCacheEntry *entry;
+  struct passwd pwstruct;
+  gchar pwbuf[8192];
+  struct passwd *pw = NULL;
+  gint64 now;
+  int rc;
+
+  now = g_get_monotonic_time ();
+
+  G_LOCK (passwd_cache_lock);
+  if (passwd_cache == NULL)
+    passwd_cache = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                          NULL, (GDestroyNotify) passwd_cache_entry_free);
+  entry = g_hash_table_lookup (passwd_cache, GUINT_TO_POINTER (uid));
+  if (entry != NULL && now - entry->timestamp < PASSWD_CACHE_TTL * G_USEC_PER_SEC)
+    {
+      *out_gid = entry->gid;
+      if (out_name != NULL)
+        *out_name = g_strdup (entry->name);
+      G_UNLOCK (passwd_cache_lock);
+      return TRUE;
+    }
+  G_UNLOCK (passwd_cache_lock);
+
+  rc = getpwuid_r (uid, &pwstruct, pwbuf, sizeof pwbuf, &pw);
+  if (rc != 0 || pw == NULL)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                   "No password record for uid %d: %s\n", (gint) uid,
+                   g_strerror (rc != 0 ? rc : ENOENT));
+      return FALSE;
+    }
+
+  entry = g_new0 (PasswdCacheEntry, 1);
+  entry->gid = pw->pw_gid;
+  entry->name = g_strdup (pw->pw_name);
+  entry->timestamp = now;
+
+  *out_gid = entry->gid;
+  if (out_name != NULL)
+    *out_name = g_strdup (entry->name);
+
+  G_LOCK (passwd_cache_lock);
+  g_hash_table_replace (passwd_cache, GUINT_TO_POINTER (uid), entry);
+  G_UNLOCK (passwd_cache_lock);
+
+  return TRUE;
+}
+
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+static GSpawnError
+spawn_error_from_errno (gint errsv)
+{
+  switch (errsv)
+    {
+    case EACCES:
+      return G_SPAWN_ERROR_ACCES;
+    case ENOENT:
+      return G_SPAWN_ERROR_NOENT;
+    case ENOEXEC:
+      return G_SPAWN_ERROR_NOEXEC;
+    case ENOTDIR:
+      return G_SPAWN_ERROR_NOTDIR;
+    case ENOMEM:
+      return G_SPAWN_ERROR_NOMEM;
+    case E2BIG:
+      return G_SPAWN_ERROR_TOO_BIG;
+    case ELOOP:
+      return G_SPAWN_ERROR_LOOP;
+    case ETXTBSY:
+      return G_SPAWN_ERROR_TXTBUSY;
+    case EIO:
+      return G_SPAWN_ERROR_IO;
+    case ENAMETOOLONG:
+      return G_SPAWN_ERROR_NAMETOOLONG;
+    case EISDIR:
+      return G_SPAWN_ERROR_ISDIR;
+    case ELIBBAD:
+      return G_SPAWN_ERROR_LIBBAD;
+    default:
+      return G_SPAWN_ERROR_FAILED;
+    }
+}
+
+/* Spawns the child using posix_spawn() which, unlike fork(), doesn't need
+ * to copy the page tables of the (big) daemon process. This is only
+ * possible when no credentials need to be switched in the child.
+ */
+static gboolean
+spawn_child_posix (UDisksSpawnedJob  *job,
+                   gchar            **argv,
+                   GError           **error)
+{
+  posix_spawn_file_actions_t file_actions;
+  posix_spawnattr_t attr;
+  sigset_t mask;
+  sigset_t default_signals;
+  gint stdin_pipe[2] = { -1, -1 };
+  gint stdout_pipe[2] = { -1, -1 };
+  gint stderr_pipe[2] = { -1, -1 };
+  pid_t pid;
+  gint rc;
+  gboolean ret = FALSE;
+
+  if (job->input_string != NULL && !g_unix_open_pipe (stdin_pipe, FD_CLOEXEC, error))
+    goto out;
+  if (!g_unix_open_pipe (stdout_pipe, FD_CLOEXEC, error))
+    goto out;
+  if (!g_unix_open_pipe (stderr_pipe, FD_CLOEXEC, error))
+    goto out;
+
+  posix_spawn_file_actions_init (&file_actions);
+  if (stdin_pipe[0] != -1)
+    posix_spawn_file_actions_adddup2 (&file_actions, stdin_pipe[0], STDIN_FILENO);
+  else
+    posix_spawn_file_actions_addopen (&file_actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  posix_spawn_file_actions_adddup2 (&file_actions, stdout_pipe[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2 (&file_actions, stderr_pipe[1], STDERR_FILENO);
+  posix_spawn_file_actions_addclosefrom_np (&file_actions, STDERR_FILENO + 1);
+
+  /* don't let the child inherit signals blocked in the calling thread nor
+   * signals ignored by the daemon (e.g. SIGPIPE), as g_spawn_*() does */
+  posix_spawnattr_init (&attr);
+  sigemptyset (&mask);
+  posix_spawnattr_setsigmask (&attr, &mask);
+  sigfillset (&default_signals);
+  posix_spawnattr_setsigdefault (&attr, &default_signals);
+  posix_spawnattr_setflags (&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+  rc = posix_spawnp (&pid, argv[0], &file_actions, &attr, argv, environ);
+
+  posix_spawnattr_destroy (&attr);
+  posix_spawn_file_actions_destroy (&file_actions);
+
+  if (rc != 0)
+    {
+      g_set_error (error, G_SPAWN_ERROR, spawn_error_from_errno (rc),
+                   _("Failed to execute child process “%s” (%s)"),
+                   argv[0], g_strerror (rc));
+      goto out;
+    }
+
+  job->child_pid = pid;
+  if (stdin_pipe[1] != -1)
+    {
+      job->child_stdin_fd = stdin_pipe[1];
+      stdin_pipe[1] = -1;
+    }
+  job->child_stdout_fd = stdout_pipe[0];
+  stdout_pipe[0] = -1;
+  job->child_stderr_fd = stderr_pipe[0];
+  stderr_pipe[0] = -1;
+
+  ret = TRUE;
+
+ out:
+  for (rc = 0; rc < 2; rc++)
+    {
+      if (stdin_pipe[rc] != -1)
+        close (stdin_pipe[rc]);
+      if (stdout_pipe[rc] != -1)
+        close (stdout_pipe[rc]);
+      if (stderr_pipe[rc] != -1)
+        close (stderr_pipe[rc]);
+    }
+  return ret;
+}
+#endif
+
+static gboolean
+spawn_child (UDisksSpawnedJob  *job,
+             gchar            **argv,
+             gboolean           switch_credentials,
+             GError           **error)
+{
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+  if (!switch_credentials)
+    return spawn_child_posix (job, argv, error);
+#endif
+
+  /* GLib forks here: it only uses posix_spawn() with G_SPAWN_LEAVE_DESCRIPTORS_OPEN,
+   * which can't be passed as not every fd in the daemon is O_CLOEXEC, and never
+   * with a child_setup function
+   */
+  return g_spawn_async_with_pipes (NULL, /* working directory */
+                                   argv,
+                                   NULL, /* envp */
+                                   G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
+                                   switch_credentials ? child_setup : NULL, /* child_setup */
+                                   job, /* child_setup's user_data */
+                                   &(job->child_pid),
+                                   job->input_string != NULL ? &(job->child_stdin_fd) : NULL,
+                                   &(job->child_stdout_fd),
+                                   &(job->child_stderr_fd),
+                                   error);
+}
+
+static void
+watch_child_output (UDisksSpawnedJob *job,
+                    ChildOutput      *output,
+                    gint              fd)
+{
+  GError *error = NULL;
+
+  if (!g_unix_set_fd_nonblocking (fd, TRUE, &error))
+    {
+      udisks_warning ("Error setting O_NONBLOCK on the output pipe of `%s': %s",
+                      job->command_line, error->message);
+      g_clear_error (&error);
+    }
+
+  /* the fd is closed in udisks_spawned_job_release_resources() */
+  output->stream = g_unix_input_stream_new (fd, FALSE);
+  output->source = g_pollable_input_stream_create_source (G_POLLABLE_INPUT_STREAM (output->stream), NULL);
+#if __GNUC__ >= 8
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-function-type"
+#endif
+/* parameters of the callback depend on the source and can be different
+ * from the required "generic" GSourceFunc, see:
+ * https://developer.gnome.org/glib/stable/glib-The-Main-Event-Loop.html#g-source-set-callback
+ */
+  g_source_set_callback (output->source, (GSourceFunc) on_child_output, output, NULL);
+#if __GNUC__ >= 8
+#pragma GCC diagnostic pop
+#endif
+  g_source_attach (output->source, job->main_context);
+  g_source_unref (output->source);
+}
+
 /**
  * udisks_spawned_job_start:
  * @job: the job to start
@@ -903,10 +1417,7 @@ void udisks_spawned_job_start (UDisksSpawnedJob *job)
   GError *error;
   gint child_argc;
   gchar **child_argv = NULL;
-  struct passwd pwstruct;
-  gchar pwbuf[8192];
-  struct passwd *pw = NULL;
-  int rc;
+  gboolean switch_credentials;
 
   job->main_context = g_main_context_get_thread_default ();
   if (job->main_context != NULL)
@@ -927,10 +1438,14 @@ void udisks_spawned_job_start (UDisksSpawnedJob *job)
                                                        NULL);
 
   error = NULL;
-  if (!g_shell_parse_argv (job->command_line,
-                           &child_argc,
-                           &child_argv,
-                           &error))
+  if (job->argv != NULL)
+    {
+      child_argv = g_strdupv (job->argv);
+    }
+  else if (!g_shell_parse_argv (job->command_line,
+                                &child_argc,
+                                &child_argv,
+                                &error))
     {
       g_prefix_error (&error,
                       "Error parsing command-line `%s': ",
@@ -941,45 +1456,21 @@ void udisks_spawned_job_start (UDisksSpawnedJob *job)
     }
 
   /* Save real egid and gid info for the child process */
-  if (job->run_as_uid != getuid () || job->run_as_euid != geteuid ())
+  switch_credentials = job->run_as_uid != getuid () || job->run_as_euid != geteuid ();
+  if (switch_credentials)
     {
-      rc = getpwuid_r (job->run_as_euid, &pwstruct, pwbuf, sizeof pwbuf, &pw);
-      if (rc != 0 || pw == NULL)
-        {
-          g_set_error(&error, G_IO_ERROR, G_IO_ERROR_FAILED,
-                      "No password record for uid %d: %m\n", (gint) job->run_as_euid);
-          emit_completed_with_error_in_idle (job, error);
-          g_clear_error (&error);
-          goto out;
-        }
-      job->real_egid = pw->pw_gid;
-
-      rc = getpwuid_r (job->run_as_uid, &pwstruct, pwbuf, sizeof pwbuf, &pw);
-      if (rc != 0 || pw == NULL)
+      if (!lookup_passwd_cached (job->run_as_euid, &job->real_egid, NULL, &error) ||
+          !lookup_passwd_cached (job->run_as_uid, &job->real_gid, &job->real_pwname, &error))
         {
-          g_set_error(&error, G_IO_ERROR, G_IO_ERROR_FAILED,
-                      "No password record for uid %d: %m\n", (gint) job->run_as_uid);
           emit_completed_with_error_in_idle (job, error);
           g_clear_error (&error);
           goto out;
         }
-      job->real_gid = pw->pw_gid;
-      job->real_uid = pw->pw_uid;
-      job->real_pwname = strdup (pw->pw_name);
+      job->real_uid = job->run_as_uid;
     }
 
   error = NULL;
-  if (!g_spawn_async_with_pipes (NULL, /* working directory */
-                                 child_argv,
-                                 NULL, /* envp */
-                                 G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
-                                 child_setup, /* child_setup */
-                                 job, /* child_setup's user_data */
-                                 &(job->child_pid),
-                                 job->input_string != NULL ? &(job->child_stdin_fd) : NULL,
-                                 &(job->child_stdout_fd),
-                                 &(job->child_stderr_fd),
-                                 &error))
+  if (!spawn_child (job, child_argv, switch_credentials, &error))
     {
       g_prefix_error (&error,
                       "Error spawning command-line `%s': ",
@@ -1031,45 +1522,8 @@ void udisks_spawned_job_start (UDisksSpawnedJob *job)
       g_source_unref (job->child_stdin_source);
     }
 
-  job->child_stdout_channel = g_io_channel_unix_new (job->child_stdout_fd);
-  /* we want to read binary, suppress checking the encoding: */
-  g_io_channel_set_encoding (job->child_stdout_channel, NULL, NULL);
-  g_io_channel_set_flags (job->child_stdout_channel, G_IO_FLAG_NONBLOCK, NULL);
-  job->child_stdout_source = g_io_create_watch (job->child_stdout_channel, G_IO_IN);
-#if __GNUC__ >= 8
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-function-type"
-#endif
-/* parameters of the callback depend on the source and can be different
- * from the required "generic" GSourceFunc, see:
- * https://developer.gnome.org/glib/stable/glib-The-Main-Event-Loop.html#g-source-set-callback
- */
-  g_source_set_callback (job->child_stdout_source, (GSourceFunc) read_child_stdout, job, NULL);
-#if __GNUC__ >= 8
-#pragma GCC diagnostic pop
-#endif
-  g_source_attach (job->child_stdout_source, job->main_context);
-  g_source_unref (job->child_stdout_source);
-
-  job->child_stderr_channel = g_io_channel_unix_new (job->child_stderr_fd);
-  /* we want to read binary, suppress checking the encoding: */
-  g_io_channel_set_encoding (job->child_stderr_channel, NULL, NULL);
-  g_io_channel_set_flags (job->child_stderr_channel, G_IO_FLAG_NONBLOCK, NULL);
-  job->child_stderr_source = g_io_create_watch (job->child_stderr_channel, G_IO_IN);
-#if __GNUC__ >= 8
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-function-type"
-#endif
-/* parameters of the callback depend on the source and can be different
- * from the required "generic" GSourceFunc, see:
- * https://developer.gnome.org/glib/stable/glib-The-Main-Event-Loop.html#g-source-set-callback
- */
-  g_source_set_callback (job->child_stderr_source, (GSourceFunc) read_child_stderr, job, NULL);
-#if __GNUC__ >= 8
-#pragma GCC diagnostic pop
-#endif
-  g_source_attach (job->child_stderr_source, job->main_context);
-  g_source_unref (job->child_stderr_source);
+  watch_child_output (job, &job->child_stdout_reader, job->child_stdout_fd);
+  watch_child_output (job, &job->child_stderr_reader, job->child_stderr_fd);
 
  out:
   g_strfreev (child_argv);
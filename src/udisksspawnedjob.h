@@ -29,6 +29,28 @@ G_BEGIN_DECLS
 #define UDISKS_SPAWNED_JOB(o)           (G_TYPE_CHECK_INSTANCE_CAST ((o), UDISKS_TYPE_SPAWNED_JOB, UDisksSpawnedJob))
 #define UDISKS_IS_SPAWNED_JOB(o)        (G_TYPE_CHECK_INSTANCE_TYPE ((o), UDISKS_TYPE_SPAWNED_JOB))
 
+/**
+ * UDISKS_SPAWNED_JOB_DEFAULT_OUTPUT_LIMIT:
+ *
+ * Default maximum number of bytes kept from each output stream of a
+ * spawned program, see udisks_spawned_job_set_output_limit().
+ */
+#define UDISKS_SPAWNED_JOB_DEFAULT_OUTPUT_LIMIT (16 * 1024 * 1024)
+
+/**
+ * UDisksSpawnedJobLineFunc:
+ * @job: A #UDisksSpawnedJob.
+ * @standard_error: %TRUE if @line comes from standard error, %FALSE if from standard output.
+ * @line: The line, without the line terminator. Only valid during the call.
+ * @user_data: User data passed to udisks_spawned_job_set_line_func().
+ *
+ * Function type for udisks_spawned_job_set_line_func().
+ */
+typedef void (*UDisksSpawnedJobLineFunc) (UDisksSpawnedJob *job,
+                                          gboolean          standard_error,
+                                          const gchar      *line,
+                                          gpointer          user_data);
+
 GType              udisks_spawned_job_get_type         (void) G_GNUC_CONST;
 UDisksSpawnedJob  *udisks_spawned_job_new              (const gchar  *command_line,
                                                         GString      *input_string,
@@ -37,6 +59,18 @@ UDisksSpawnedJob  *udisks_spawned_job_new              (const gchar  *command_li
                                                         UDisksDaemon *daemon,
                                                         GCancellable *cancellable);
 const gchar       *udisks_spawned_job_get_command_line (UDisksSpawnedJob *job);
+UDisksSpawnedJob  *udisks_spawned_job_new_argv         (const gchar * const *argv,
+                                                        GString             *input_string,
+                                                        uid_t                run_as_uid,
+                                                        uid_t                run_as_euid,
+                                                        UDisksDaemon        *daemon,
+                                                        GCancellable        *cancellable);
+void               udisks_spawned_job_set_line_func    (UDisksSpawnedJob         *job,
+                                                        UDisksSpawnedJobLineFunc  func,
+                                                        gpointer                  user_data,
+                                                        GDestroyNotify            user_data_free_func);
+void               udisks_spawned_job_set_output_limit (UDisksSpawnedJob *job,
+                                                        gsize             limit);
 void udisks_spawned_job_start (UDisksSpawnedJob *job);
 
 G_END_DECLS
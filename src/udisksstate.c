@@ -774,33 +774,29 @@ udisks_state_check_mounted_fs_entry (UDisksState  *state,
 
       if (is_mounted)
         {
-          gchar *escaped_mount_point;
+          const gchar *argv[] = { "umount", "-l", mount_point, NULL };
           gchar *error_message;
 
           error_message = NULL;
-          escaped_mount_point = g_shell_quote (mount_point);
           /* right now -l is the only way to "force unmount" file systems... */
-          if (!udisks_daemon_launch_spawned_job_sync (state->daemon,
-                                                      NULL, /* UDisksObject */
-                                                      "cleanup", 0, /* StartedByUID */
-                                                      NULL, /* GCancellable */
-                                                      0,    /* uid_t run_as_uid */
-                                                      0,    /* uid_t run_as_euid */
-                                                      NULL, /* gint *out_status */
-                                                      &error_message,
-                                                      NULL,  /* input_string */
-                                                      "umount -l %s",
-                                                      escaped_mount_point))
+          if (!udisks_daemon_launch_spawned_job_argv_sync (state->daemon,
+                                                           NULL, /* UDisksObject */
+                                                           "cleanup", 0, /* StartedByUID */
+                                                           NULL, /* GCancellable */
+                                                           0,    /* uid_t run_as_uid */
+                                                           0,    /* uid_t run_as_euid */
+                                                           NULL, /* gint *out_status */
+                                                           &error_message,
+                                                           NULL, /* input_string */
+                                                           argv))
             {
               udisks_critical ("Error cleaning up mount point %s: Error unmounting: %s",
                             mount_point, error_message);
-              g_free (escaped_mount_point);
               g_free (error_message);
               /* keep the entry so we can clean it up later */
               keep = TRUE;
               goto out2;
             }
-          g_free (escaped_mount_point);
           g_free (error_message);
 
           /* just unmounting the device does not make the kernel revalidate media
@@ -120,6 +120,26 @@ shutdown_local_polkit_agent (void)
     g_object_unref (local_polkit_agent);
 }
 
+/* ---------------------------------------------------------------------------------------------------- */
+
+static gboolean
+connect_client (void)
+{
+  GError *error = NULL;
+
+  if (client != NULL)
+    return TRUE;
+
+  client = udisks_client_new_sync (NULL, /* GCancellable */
+                                   &error);
+  if (client == NULL)
+    {
+      g_printerr ("Error connecting to the udisks daemon: %s\n", error->message);
+      g_clear_error (&error);
+      return FALSE;
+    }
+  return TRUE;
+}
 
 /* ---------------------------------------------------------------------------------------------------- */
 
@@ -149,6 +169,7 @@ typedef enum
 static gboolean _color_stdin_is_tty = FALSE;
 static gboolean _color_initialized = FALSE;
 static FILE *_color_pager_out = NULL;
+static gboolean _color_pager_disabled = FALSE;
 
 static void
 _color_init (void)
@@ -214,7 +235,7 @@ _color_run_pager (void)
   const gchar *pager_program;
 
   _color_init ();
-  if (!_color_stdin_is_tty)
+  if (!_color_stdin_is_tty || _color_pager_disabled || _color_pager_out != NULL)
     goto out;
 
   pager_program = g_getenv ("PAGER");
@@ -290,17 +311,71 @@ if_proxy_cmp (GDBusProxy *a,
   return g_strcmp0 (g_dbus_proxy_get_interface_name (a), g_dbus_proxy_get_interface_name (b));
 }
 
+/* Returns TRUE if @str matches any of the glob-style @patterns or if @patterns is %NULL */
+static gboolean
+matches_any_pattern (const gchar *const *patterns,
+                     const gchar        *str)
+{
+  guint n;
+
+  if (patterns == NULL)
+    return TRUE;
+
+  for (n = 0; patterns[n] != NULL; n++)
+    {
+      if (g_pattern_match_simple (patterns[n], str))
+        return TRUE;
+    }
+  return FALSE;
+}
+
+/* Interfaces may be given either with or without the org.freedesktop.UDisks2. prefix */
+static gboolean
+interface_matches (const gchar *const *patterns,
+                   const gchar        *interface_name)
+{
+  if (matches_any_pattern (patterns, interface_name))
+    return TRUE;
+  if (g_str_has_prefix (interface_name, "org.freedesktop.UDisks2."))
+    return matches_any_pattern (patterns, interface_name + strlen ("org.freedesktop.UDisks2."));
+  return FALSE;
+}
+
+/* Like g_dbus_proxy_get_cached_property_names() but only returns properties matching @patterns */
+static gchar **
+get_cached_property_names_filtered (GDBusProxy         *proxy,
+                                    const gchar *const *patterns)
+{
+  gchar **names;
+  guint n, m;
+
+  /* note: this is guaranteed to be sorted */
+  names = g_dbus_proxy_get_cached_property_names (proxy);
+  if (names == NULL || patterns == NULL)
+    return names;
+
+  for (n = 0, m = 0; names[n] != NULL; n++)
+    {
+      if (matches_any_pattern (patterns, names[n]))
+        names[m++] = names[n];
+      else
+        g_free (names[n]);
+    }
+  names[m] = NULL;
+  return names;
+}
+
 static void
-print_interface_properties (GDBusProxy *proxy,
-                            guint       indent)
+print_interface_properties (GDBusProxy         *proxy,
+                            guint               indent,
+                            const gchar *const *property_patterns)
 {
   gchar **cached_properties;
   guint n;
   guint value_column;
   guint max_property_name_len;
 
-  /* note: this is guaranteed to be sorted */
-  cached_properties = g_dbus_proxy_get_cached_property_names (proxy);
+  cached_properties = get_cached_property_names_filtered (proxy, property_patterns);
 
   max_property_name_len = 0;
   for (n = 0; cached_properties != NULL && cached_properties[n] != NULL; n++)
@@ -347,19 +422,36 @@ print_interface_properties (GDBusProxy *proxy,
   g_strfreev (cached_properties);
 }
 
-static void
-print_object (UDisksObject *object,
-              guint        indent)
+/* Returns the interfaces of @object matching @interface_patterns, sorted by name */
+static GList *
+get_interfaces_filtered (UDisksObject       *object,
+                         const gchar *const *interface_patterns)
 {
   GList *interface_proxies;
+  GList *ret = NULL;
   GList *l;
 
-  g_return_if_fail (G_IS_DBUS_OBJECT (object));
-
   interface_proxies = g_dbus_object_get_interfaces (G_DBUS_OBJECT (object));
+  for (l = interface_proxies; l != NULL; l = l->next)
+    {
+      GDBusProxy *iproxy = G_DBUS_PROXY (l->data);
+      if (interface_matches (interface_patterns, g_dbus_proxy_get_interface_name (iproxy)))
+        ret = g_list_prepend (ret, iproxy);
+      else
+        g_object_unref (iproxy);
+    }
+  g_list_free (interface_proxies);
 
   /* We want to print the interfaces in order */
-  interface_proxies = g_list_sort (interface_proxies, (GCompareFunc) if_proxy_cmp);
+  return g_list_sort (ret, (GCompareFunc) if_proxy_cmp);
+}
+
+static void
+print_interfaces (GList              *interface_proxies,
+                  guint               indent,
+                  const gchar *const *property_patterns)
+{
+  GList *l;
 
   for (l = interface_proxies; l != NULL; l = l->next)
     {
@@ -367,11 +459,59 @@ print_object (UDisksObject *object,
       g_print ("%*s%s%s%s:%s\n",
                indent, "",
                _color_get (_COLOR_BOLD_ON), _color_get (_COLOR_FG_MAGENTA), g_dbus_proxy_get_interface_name (iproxy), _color_get (_COLOR_RESET));
-      print_interface_properties (iproxy, indent + 2);
+      print_interface_properties (iproxy, indent + 2, property_patterns);
     }
+}
+
+static void
+print_object (UDisksObject *object,
+              guint        indent)
+{
+  GList *interface_proxies;
+
+  g_return_if_fail (G_IS_DBUS_OBJECT (object));
+
+  interface_proxies = get_interfaces_filtered (object, NULL);
+  print_interfaces (interface_proxies, indent, NULL);
   g_list_free_full (interface_proxies, g_object_unref);
 }
 
+/* Prints one "OBJECT<tab>INTERFACE<tab>PROPERTY<tab>VALUE" line per property
+ * with VALUE in the GVariant text format, suitable for parsing by scripts.
+ */
+static void
+print_interfaces_terse (const gchar        *object_path,
+                        GList              *interface_proxies,
+                        const gchar *const *property_patterns)
+{
+  GList *l;
+  guint n;
+
+  for (l = interface_proxies; l != NULL; l = l->next)
+    {
+      GDBusProxy *iproxy = G_DBUS_PROXY (l->data);
+      gchar **property_names;
+
+      property_names = get_cached_property_names_filtered (iproxy, property_patterns);
+      for (n = 0; property_names != NULL && property_names[n] != NULL; n++)
+        {
+          GVariant *value;
+          gchar *value_str;
+
+          value = g_dbus_proxy_get_cached_property (iproxy, property_names[n]);
+          value_str = g_variant_print (value, TRUE);
+          g_print ("%s\t%s\t%s\t%s\n",
+                   object_path,
+                   g_dbus_proxy_get_interface_name (iproxy),
+                   property_names[n],
+                   value_str);
+          g_free (value_str);
+          g_variant_unref (value);
+        }
+      g_strfreev (property_names);
+    }
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 static UDisksObject *
@@ -2581,11 +2721,77 @@ obj_proxy_drive_sortkey_cmp (GDBusObject *a,
 }
 
 
+static gchar **opt_dump_objects = NULL;
+static gchar **opt_dump_interfaces = NULL;
+static gchar **opt_dump_properties = NULL;
+static gboolean opt_dump_terse = FALSE;
+
 static const GOptionEntry command_dump_entries[] =
 {
+  { "object-path", 'p', 0, G_OPTION_ARG_STRING_ARRAY, &opt_dump_objects, "Only show objects matching PATTERN", "PATTERN"},
+  { "interface", 'i', 0, G_OPTION_ARG_STRING_ARRAY, &opt_dump_interfaces, "Only show interfaces matching PATTERN", "PATTERN"},
+  { "property", 'P', 0, G_OPTION_ARG_STRING_ARRAY, &opt_dump_properties, "Only show properties matching PATTERN", "PATTERN"},
+  { "terse", 't', 0, G_OPTION_ARG_NONE, &opt_dump_terse, "Print one tab-separated line per property", NULL},
   { NULL }
 };
 
+static gboolean
+is_pattern (const gchar *str)
+{
+  return strpbrk (str, "*?") != NULL;
+}
+
+/* Gets the objects to dump. If only literal object paths are given
+ * they are looked up directly instead of walking all objects.
+ */
+static GList *
+get_objects_for_dump (void)
+{
+  GList *ret = NULL;
+  GList *objects;
+  GList *l;
+  guint n;
+
+  if (opt_dump_objects != NULL)
+    {
+      for (n = 0; opt_dump_objects[n] != NULL; n++)
+        {
+          if (is_pattern (opt_dump_objects[n]))
+            break;
+        }
+      if (opt_dump_objects[n] == NULL)
+        {
+          for (n = 0; opt_dump_objects[n] != NULL; n++)
+            {
+              UDisksObject *object;
+
+              object = udisks_client_get_object (client, opt_dump_objects[n]);
+              if (object != NULL && g_list_find (ret, object) == NULL)
+                ret = g_list_prepend (ret, object);
+              else if (object != NULL)
+                g_object_unref (object);
+            }
+          goto out;
+        }
+    }
+
+  objects = g_dbus_object_manager_get_objects (udisks_client_get_object_manager (client));
+  for (l = objects; l != NULL; l = l->next)
+    {
+      GDBusObject *object = G_DBUS_OBJECT (l->data);
+
+      if (matches_any_pattern ((const gchar *const *) opt_dump_objects, g_dbus_object_get_object_path (object)))
+        ret = g_list_prepend (ret, object);
+      else
+        g_object_unref (object);
+    }
+  g_list_free (objects);
+
+ out:
+  /* We want to print the objects in order */
+  return g_list_sort (ret, (GCompareFunc) obj_proxy_cmp);
+}
+
 static gint
 handle_command_dump (gint        *argc,
                      gchar      **argv[],
@@ -2601,6 +2807,10 @@ handle_command_dump (gint        *argc,
   gboolean first;
 
   ret = 1;
+  opt_dump_objects = NULL;
+  opt_dump_interfaces = NULL;
+  opt_dump_properties = NULL;
+  opt_dump_terse = FALSE;
 
   modify_argv0_for_command (argc, argv, "dump");
 
@@ -2624,23 +2834,37 @@ handle_command_dump (gint        *argc,
 
   /* done with completion */
   if (request_completion)
-    goto out;
+    {
+      list_options (command_dump_entries);
+      goto out;
+    }
 
-  _color_run_pager ();
+  if (!opt_dump_terse)
+    _color_run_pager ();
 
-  objects = g_dbus_object_manager_get_objects (udisks_client_get_object_manager (client));
-  /* We want to print the objects in order */
-  objects = g_list_sort (objects, (GCompareFunc) obj_proxy_cmp);
+  objects = get_objects_for_dump ();
   first = TRUE;
   for (l = objects; l != NULL; l = l->next)
     {
       UDisksObject *object = UDISKS_OBJECT (l->data);
-      if (!first)
-        g_print ("\n");
-      first = FALSE;
-      g_print ("%s%s%s:%s\n",
-               _color_get (_COLOR_BOLD_ON), _color_get (_COLOR_FG_BLUE), g_dbus_object_get_object_path (G_DBUS_OBJECT (object)), _color_get (_COLOR_RESET));
-      print_object (object, 2);
+      const gchar *object_path = g_dbus_object_get_object_path (G_DBUS_OBJECT (object));
+      GList *interface_proxies;
+
+      interface_proxies = get_interfaces_filtered (object, (const gchar *const *) opt_dump_interfaces);
+      if (opt_dump_terse)
+        {
+          print_interfaces_terse (object_path, interface_proxies, (const gchar *const *) opt_dump_properties);
+        }
+      else if (interface_proxies != NULL)
+        {
+          if (!first)
+            g_print ("\n");
+          first = FALSE;
+          g_print ("%s%s%s:%s\n",
+                   _color_get (_COLOR_BOLD_ON), _color_get (_COLOR_FG_BLUE), object_path, _color_get (_COLOR_RESET));
+          print_interfaces (interface_proxies, 2, (const gchar *const *) opt_dump_properties);
+        }
+      g_list_free_full (interface_proxies, g_object_unref);
     }
   g_list_free_full (objects, g_object_unref);
 
@@ -2651,6 +2875,9 @@ handle_command_dump (gint        *argc,
 
  out:
   g_option_context_free (o);
+  g_strfreev (opt_dump_objects);
+  g_strfreev (opt_dump_interfaces);
+  g_strfreev (opt_dump_properties);
   return ret;
 }
 
@@ -2753,7 +2980,7 @@ monitor_on_interface_proxy_added (GDBusObjectManager  *manager,
              g_dbus_proxy_get_interface_name (G_DBUS_PROXY (interface)),
            _color_get (_COLOR_RESET));
 
-  print_interface_properties (G_DBUS_PROXY (interface), 2);
+  print_interface_properties (G_DBUS_PROXY (interface), 2, NULL);
  out:
   ;
 }
@@ -2887,8 +3114,430 @@ monitor_on_interface_proxy_signal (GDBusObjectManagerClient  *manager,
 }
 
 
+/* ---------------------------------------------------------------------------------------------------- */
+
+/* The event feed used by `monitor` when filtering, coalescing or terse
+ * output is requested. It doesn't use the UDisksClient object manager,
+ * which loads all objects and receives every signal emitted by the
+ * daemon. Instead literal object paths and interface names are turned
+ * into D-Bus match rules so the message bus only delivers the matching
+ * signals. Patterns with wildcards can't be expressed as match rules and
+ * are checked when a signal is received.
+ */
+
+static gchar **opt_monitor_objects = NULL;
+static gchar **opt_monitor_interfaces = NULL;
+static gchar **opt_monitor_properties = NULL;
+static gint    opt_monitor_coalesce = 0;
+static gboolean opt_monitor_terse = FALSE;
+
+typedef enum
+{
+  MONITOR_SIGNAL_OBJECT_MANAGER,
+  MONITOR_SIGNAL_PROPERTIES_CHANGED,
+  MONITOR_SIGNAL_OTHER
+} MonitorSignalKind;
+
+typedef struct
+{
+  gchar      *object_path;
+  gchar      *interface_name;
+  GHashTable *properties;     /* property name -> GVariant */
+} MonitorPendingChange;
+
+static GHashTable *monitor_pending_changes = NULL;  /* "path\tinterface" -> MonitorPendingChange */
+static GPtrArray  *monitor_pending_order = NULL;    /* keys of monitor_pending_changes in arrival order */
+static guint       monitor_flush_source_id = 0;
+
+static void
+monitor_pending_change_free (MonitorPendingChange *change)
+{
+  g_free (change->object_path);
+  g_free (change->interface_name);
+  g_hash_table_unref (change->properties);
+  g_free (change);
+}
+
+static void
+monitor_feed_print_event (const gchar *event,
+                          const gchar *object_path,
+                          const gchar *interface_name,
+                          const gchar *detail1,
+                          const gchar *detail2)
+{
+  GDateTime *now;
+  gchar *time_str;
+
+  now = g_date_time_new_now_local ();
+  time_str = g_date_time_format_iso8601 (now);
+  g_print ("%s\t%s\t%s\t%s",
+           time_str, event,
+           object_path != NULL ? object_path : "-",
+           interface_name != NULL ? interface_name : "-");
+  if (detail1 != NULL)
+    g_print ("\t%s", detail1);
+  if (detail2 != NULL)
+    g_print ("\t%s", detail2);
+  g_print ("\n");
+  g_free (time_str);
+  g_date_time_unref (now);
+}
+
+static void
+monitor_feed_print_changed (const gchar *object_path,
+                            const gchar *interface_name,
+                            GHashTable  *properties)
+{
+  GList *names;
+  GList *l;
+
+  names = g_list_sort (g_hash_table_get_keys (properties), (GCompareFunc) g_strcmp0);
+  for (l = names; l != NULL; l = l->next)
+    {
+      const gchar *property_name = l->data;
+      gchar *value_str;
+
+      value_str = g_variant_print (g_hash_table_lookup (properties, property_name), FALSE);
+      monitor_feed_print_event ("changed", object_path, interface_name, property_name, value_str);
+      g_free (value_str);
+    }
+  g_list_free (names);
+}
+
+static gboolean
+monitor_feed_flush_changes (gpointer user_data)
+{
+  guint n;
+
+  for (n = 0; n < monitor_pending_order->len; n++)
+    {
+      MonitorPendingChange *change;
+
+      change = g_hash_table_lookup (monitor_pending_changes, monitor_pending_order->pdata[n]);
+      monitor_feed_print_changed (change->object_path, change->interface_name, change->properties);
+    }
+  g_ptr_array_set_size (monitor_pending_order, 0);
+  g_hash_table_remove_all (monitor_pending_changes);
+
+  monitor_flush_source_id = 0;
+  return G_SOURCE_REMOVE;
+}
+
+/* Takes ownership of @properties */
+static void
+monitor_feed_queue_changes (const gchar *object_path,
+                            const gchar *interface_name,
+                            GHashTable  *properties)
+{
+  MonitorPendingChange *change;
+  GHashTableIter iter;
+  gpointer name;
+  gpointer value;
+  gchar *key;
+
+  if (opt_monitor_coalesce <= 0)
+    {
+      monitor_feed_print_changed (object_path, interface_name, properties);
+      g_hash_table_unref (properties);
+      return;
+    }
+
+  /* later updates of the same property within the window replace the earlier ones */
+  key = g_strdup_printf ("%s\t%s", object_path, interface_name);
+  change = g_hash_table_lookup (monitor_pending_changes, key);
+  if (change == NULL)
+    {
+      change = g_new0 (MonitorPendingChange, 1);
+      change->object_path = g_strdup (object_path);
+      change->interface_name = g_strdup (interface_name);
+      change->properties = properties;
+      g_hash_table_insert (monitor_pending_changes, key, change);
+      g_ptr_array_add (monitor_pending_order, key);
+    }
+  else
+    {
+      g_hash_table_iter_init (&iter, properties);
+      while (g_hash_table_iter_next (&iter, &name, &value))
+        g_hash_table_replace (change->properties, g_strdup (name), g_variant_ref (value));
+      g_hash_table_unref (properties);
+      g_free (key);
+    }
+
+  if (monitor_flush_source_id == 0)
+    monitor_flush_source_id = g_timeout_add (opt_monitor_coalesce, monitor_feed_flush_changes, NULL);
+}
+
+static void
+monitor_feed_on_properties_changed (const gchar *object_path,
+                                    GVariant    *parameters)
+{
+  const gchar *interface_name;
+  GVariantIter *iter;
+  const gchar *property_name;
+  GVariant *value;
+  GHashTable *properties;
+
+  g_variant_get (parameters, "(&sa{sv}@as)", &interface_name, &iter, NULL);
+  if (!interface_matches ((const gchar *const *) opt_monitor_interfaces, interface_name))
+    goto out;
+
+  properties = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+  while (g_variant_iter_next (iter, "{&sv}", &property_name, &value))
+    {
+      if (matches_any_pattern ((const gchar *const *) opt_monitor_properties, property_name))
+        g_hash_table_replace (properties, g_strdup (property_name), value);
+      else
+        g_variant_unref (value);
+    }
+
+  if (g_hash_table_size (properties) > 0)
+    monitor_feed_queue_changes (object_path, interface_name, properties);
+  else
+    g_hash_table_unref (properties);
+
+ out:
+  g_variant_iter_free (iter);
+}
+
+static void
+monitor_feed_on_object_manager_signal (const gchar *signal_name,
+                                       GVariant    *parameters)
+{
+  const gchar *object_path;
+  const gchar *interface_name;
+  GVariantIter *iter;
+
+  if (g_strcmp0 (signal_name, "InterfacesAdded") == 0)
+    {
+      g_variant_get (parameters, "(&oa{sa{sv}})", &object_path, &iter);
+      if (matches_any_pattern ((const gchar *const *) opt_monitor_objects, object_path))
+        {
+          while (g_variant_iter_next (iter, "{&s@a{sv}}", &interface_name, NULL))
+            {
+              if (interface_matches ((const gchar *const *) opt_monitor_interfaces, interface_name))
+                monitor_feed_print_event ("added", object_path, interface_name, NULL, NULL);
+            }
+        }
+      g_variant_iter_free (iter);
+    }
+  else if (g_strcmp0 (signal_name, "InterfacesRemoved") == 0)
+    {
+      g_variant_get (parameters, "(&oas)", &object_path, &iter);
+      if (matches_any_pattern ((const gchar *const *) opt_monitor_objects, object_path))
+        {
+          while (g_variant_iter_next (iter, "&s", &interface_name))
+            {
+              if (interface_matches ((const gchar *const *) opt_monitor_interfaces, interface_name))
+                monitor_feed_print_event ("removed", object_path, interface_name, NULL, NULL);
+            }
+        }
+      g_variant_iter_free (iter);
+    }
+}
+
+static void
+monitor_feed_on_signal (GDBusConnection *connection,
+                        const gchar     *sender_name,
+                        const gchar     *object_path,
+                        const gchar     *interface_name,
+                        const gchar     *signal_name,
+                        GVariant        *parameters,
+                        gpointer         user_data)
+{
+  MonitorSignalKind kind = GPOINTER_TO_INT (user_data);
+  gchar *param_str;
+
+  switch (kind)
+    {
+    case MONITOR_SIGNAL_OBJECT_MANAGER:
+      monitor_feed_on_object_manager_signal (signal_name, parameters);
+      break;
+
+    case MONITOR_SIGNAL_PROPERTIES_CHANGED:
+      if (matches_any_pattern ((const gchar *const *) opt_monitor_objects, object_path))
+        monitor_feed_on_properties_changed (object_path, parameters);
+      break;
+
+    case MONITOR_SIGNAL_OTHER:
+      /* handled by the subscriptions above */
+      if (g_str_has_prefix (interface_name, "org.freedesktop.DBus."))
+        break;
+      if (!matches_any_pattern ((const gchar *const *) opt_monitor_objects, object_path) ||
+          !interface_matches ((const gchar *const *) opt_monitor_interfaces, interface_name))
+        break;
+      param_str = g_variant_print (parameters, FALSE);
+      monitor_feed_print_event ("signal", object_path, interface_name, signal_name, param_str);
+      g_free (param_str);
+      break;
+    }
+}
+
+static void
+monitor_feed_on_name_appeared (GDBusConnection *connection,
+                               const gchar     *name,
+                               const gchar     *name_owner,
+                               gpointer         user_data)
+{
+  monitor_feed_print_event ("daemon", NULL, NULL, "running", name_owner);
+}
+
+static void
+monitor_feed_on_name_vanished (GDBusConnection *connection,
+                               const gchar     *name,
+                               gpointer         user_data)
+{
+  monitor_feed_print_event ("daemon", NULL, NULL, "not-running", NULL);
+}
+
+/* Returns the literal (non-wildcard) entries of @patterns or %NULL if
+ * there are none or any entry is a wildcard pattern, i.e. if no match
+ * rule can be narrowed down by them. If @expand_interfaces is %TRUE
+ * short interface names are expanded to full names.
+ */
+static gchar **
+monitor_feed_get_literals (gchar    **patterns,
+                           gboolean   expand_interfaces)
+{
+  GPtrArray *p;
+  guint n;
+
+  if (patterns == NULL)
+    return NULL;
+
+  for (n = 0; patterns[n] != NULL; n++)
+    {
+      if (is_pattern (patterns[n]))
+        return NULL;
+    }
+
+  p = g_ptr_array_new ();
+  for (n = 0; patterns[n] != NULL; n++)
+    {
+      if (expand_interfaces && !g_str_has_prefix (patterns[n], "org.freedesktop."))
+        g_ptr_array_add (p, g_strdup_printf ("org.freedesktop.UDisks2.%s", patterns[n]));
+      else
+        g_ptr_array_add (p, g_strdup (patterns[n]));
+    }
+  g_ptr_array_add (p, NULL);
+  return (gchar **) g_ptr_array_free (p, FALSE);
+}
+
+static void
+monitor_feed_subscribe (GDBusConnection   *connection,
+                        GArray            *subscriptions,
+                        const gchar       *interface_name,
+                        const gchar       *member,
+                        const gchar       *object_path,
+                        const gchar       *arg0,
+                        GDBusSignalFlags   flags,
+                        MonitorSignalKind  kind)
+{
+  guint id;
+
+  id = g_dbus_connection_signal_subscribe (connection,
+                                           "org.freedesktop.UDisks2",
+                                           interface_name,
+                                           member,
+                                           object_path,
+                                           arg0,
+                                           flags,
+                                           monitor_feed_on_signal,
+                                           GINT_TO_POINTER (kind),
+                                           NULL); /* user_data_free_func */
+  g_array_append_val (subscriptions, id);
+}
+
+static gint
+monitor_feed_run (void)
+{
+  GDBusConnection *connection;
+  GError *error;
+  GArray *subscriptions;
+  gchar **object_paths;
+  gchar **interfaces;
+  guint watch_id;
+  guint n, m;
+
+  error = NULL;
+  connection = g_bus_get_sync (G_BUS_TYPE_SYSTEM, NULL, &error);
+  if (connection == NULL)
+    {
+      g_printerr ("Error connecting to the system bus: %s\n", error->message);
+      g_clear_error (&error);
+      return 1;
+    }
+
+  monitor_pending_changes = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                   g_free, (GDestroyNotify) monitor_pending_change_free);
+  monitor_pending_order = g_ptr_array_new ();
+  subscriptions = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  object_paths = monitor_feed_get_literals (opt_monitor_objects, FALSE);
+  interfaces = monitor_feed_get_literals (opt_monitor_interfaces, TRUE);
+
+  /* InterfacesAdded and InterfacesRemoved carry the object path in arg0 */
+  for (n = 0; n == 0 || (object_paths != NULL && object_paths[n] != NULL); n++)
+    {
+      monitor_feed_subscribe (connection, subscriptions,
+                              "org.freedesktop.DBus.ObjectManager", NULL,
+                              "/org/freedesktop/UDisks2",
+                              object_paths != NULL ? object_paths[n] : NULL,
+                              object_paths != NULL ? G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_PATH : G_DBUS_SIGNAL_FLAGS_NONE,
+                              MONITOR_SIGNAL_OBJECT_MANAGER);
+    }
+
+  /* PropertiesChanged carries the interface name in arg0, one rule per object path and interface */
+  for (n = 0; n == 0 || (object_paths != NULL && object_paths[n] != NULL); n++)
+    {
+      for (m = 0; m == 0 || (interfaces != NULL && interfaces[m] != NULL); m++)
+        {
+          const gchar *object_path = object_paths != NULL ? object_paths[n] : NULL;
+          const gchar *interface_name = interfaces != NULL ? interfaces[m] : NULL;
+
+          monitor_feed_subscribe (connection, subscriptions,
+                                  "org.freedesktop.DBus.Properties", "PropertiesChanged",
+                                  object_path, interface_name,
+                                  G_DBUS_SIGNAL_FLAGS_NONE,
+                                  MONITOR_SIGNAL_PROPERTIES_CHANGED);
+          monitor_feed_subscribe (connection, subscriptions,
+                                  interface_name, NULL,
+                                  object_path, NULL,
+                                  G_DBUS_SIGNAL_FLAGS_NONE,
+                                  MONITOR_SIGNAL_OTHER);
+        }
+    }
+
+  watch_id = g_bus_watch_name_on_connection (connection,
+                                             "org.freedesktop.UDisks2",
+                                             G_BUS_NAME_WATCHER_FLAGS_NONE,
+                                             monitor_feed_on_name_appeared,
+                                             monitor_feed_on_name_vanished,
+                                             NULL,  /* user_data */
+                                             NULL); /* user_data_free_func */
+
+  g_main_loop_run (loop);
+
+  g_bus_unwatch_name (watch_id);
+  for (n = 0; n < subscriptions->len; n++)
+    g_dbus_connection_signal_unsubscribe (connection, g_array_index (subscriptions, guint, n));
+  g_array_unref (subscriptions);
+  if (monitor_flush_source_id != 0)
+    g_source_remove (monitor_flush_source_id);
+  g_ptr_array_unref (monitor_pending_order);
+  g_hash_table_unref (monitor_pending_changes);
+  g_strfreev (object_paths);
+  g_strfreev (interfaces);
+  g_object_unref (connection);
+  return 0;
+}
+
 static const GOptionEntry command_monitor_entries[] =
 {
+  { "object-path", 'p', 0, G_OPTION_ARG_STRING_ARRAY, &opt_monitor_objects, "Only report objects matching PATTERN", "PATTERN"},
+  { "interface", 'i', 0, G_OPTION_ARG_STRING_ARRAY, &opt_monitor_interfaces, "Only report interfaces matching PATTERN", "PATTERN"},
+  { "property", 'P', 0, G_OPTION_ARG_STRING_ARRAY, &opt_monitor_properties, "Only report properties matching PATTERN", "PATTERN"},
+  { "coalesce", 'c', 0, G_OPTION_ARG_INT, &opt_monitor_coalesce, "Collapse property changes within MSEC milliseconds", "MSEC"},
+  { "terse", 't', 0, G_OPTION_ARG_NONE, &opt_monitor_terse, "Print one tab-separated line per event", NULL},
   { NULL }
 };
 
@@ -2905,6 +3554,11 @@ handle_command_monitor (gint        *argc,
   GDBusObjectManager *manager;
 
   ret = 1;
+  opt_monitor_objects = NULL;
+  opt_monitor_interfaces = NULL;
+  opt_monitor_properties = NULL;
+  opt_monitor_coalesce = 0;
+  opt_monitor_terse = FALSE;
 
   modify_argv0_for_command (argc, argv, "monitor");
 
@@ -2926,8 +3580,20 @@ handle_command_monitor (gint        *argc,
         }
     }
 
-  /* done with completion */
   if (request_completion)
+    {
+      list_options (command_monitor_entries);
+      goto out;
+    }
+
+  if (opt_monitor_objects != NULL || opt_monitor_interfaces != NULL || opt_monitor_properties != NULL ||
+      opt_monitor_coalesce > 0 || opt_monitor_terse)
+    {
+      ret = monitor_feed_run ();
+      goto out;
+    }
+
+  if (!connect_client ())
     goto out;
 
   g_print ("Monitoring the udisks daemon. Press Ctrl+C to exit.\n");
@@ -2971,39 +3637,60 @@ handle_command_monitor (gint        *argc,
 
  out:
   g_option_context_free (o);
+  g_strfreev (opt_monitor_objects);
+  g_strfreev (opt_monitor_interfaces);
+  g_strfreev (opt_monitor_properties);
   return ret;
 }
 
 /* ---------------------------------------------------------------------------------------------------- */
 
-static GList *
-find_blocks_for_drive (GList       *objects,
-                       const gchar *drive_object_path)
+/* Groups the whole-disk block devices by drive in a single pass over
+ * @objects, returning a hash table from drive object path to a
+ * space-separated list of device names.
+ */
+static GHashTable *
+group_blocks_by_drive (GList *objects)
 {
-  GList *ret;
+  GHashTable *ret;
   GList *l;
 
-  ret = NULL;
+  ret = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_free);
   for (l = objects; l != NULL; l = l->next)
     {
       UDisksObject *object = UDISKS_OBJECT (l->data);
       UDisksBlock *block;
+      const gchar *drive_object_path;
+      const gchar *device_file;
+      gchar *devices;
 
-      block = udisks_object_get_block (object);
-      if (block == NULL)
+      block = udisks_object_peek_block (object);
+      if (block == NULL || udisks_object_peek_partition (object) != NULL)
         continue;
 
-      if (g_strcmp0 (udisks_block_get_drive (block), drive_object_path) == 0)
-        {
-          ret = g_list_append (ret, g_object_ref (block));
-        }
-      g_object_unref (block);
+      drive_object_path = udisks_block_get_drive (block);
+      if (g_strcmp0 (drive_object_path, "/") == 0)
+        continue;
+
+      device_file = udisks_block_get_device (block);
+      if (g_str_has_prefix (device_file, "/dev/"))
+        device_file += 5;
+
+      devices = g_hash_table_lookup (ret, drive_object_path);
+      if (devices != NULL)
+        devices = g_strdup_printf ("%s %s", devices, device_file);
+      else
+        devices = g_strdup (device_file);
+      g_hash_table_replace (ret, g_strdup (drive_object_path), devices);
     }
   return ret;
 }
 
+static gboolean opt_status_terse = FALSE;
+
 static const GOptionEntry command_status_entries[] =
 {
+  { "terse", 't', 0, G_OPTION_ARG_NONE, &opt_status_terse, "Print tab-separated lines without a header", NULL},
   { NULL }
 };
 
@@ -3047,8 +3734,10 @@ handle_command_status (gint        *argc,
   gchar *s;
   GList *l;
   GList *objects;
+  GHashTable *drive_blocks;
 
   ret = 1;
+  opt_status_terse = FALSE;
 
   modify_argv0_for_command (argc, argv, "status");
 
@@ -3072,9 +3761,13 @@ handle_command_status (gint        *argc,
 
   /* done with completion */
   if (request_completion)
-    goto out;
+    {
+      list_options (command_status_entries);
+      goto out;
+    }
 
   objects = g_dbus_object_manager_get_objects (udisks_client_get_object_manager (client));
+  drive_blocks = group_blocks_by_drive (objects);
 
   /* print all drives
    *
@@ -3085,8 +3778,9 @@ handle_command_status (gint        *argc,
    *  - revision  <= 8    (SCSI: 6, ATA: 8)
    *  - serial    <= 20   (SCSI: 16, ATA: 20)
    */
-  g_print ("MODEL                     REVISION  SERIAL               DEVICE\n"
-           "--------------------------------------------------------------------------\n");
+  if (!opt_status_terse)
+    g_print ("MODEL                     REVISION  SERIAL               DEVICE\n"
+             "--------------------------------------------------------------------------\n");
          /* SEAGATE ST3300657SS       0006      3SJ1QNMQ00009052NECM sdaa sdab dm-32   */
          /* 01234567890123456789012345678901234567890123456789012345678901234567890123456789 */
 
@@ -3096,45 +3790,20 @@ handle_command_status (gint        *argc,
     {
       UDisksObject *object = UDISKS_OBJECT (l->data);
       UDisksDrive *drive;
-      GList *blocks;
       const gchar *vendor;
       const gchar *model;
       const gchar *revision;
       const gchar *serial;
+      const gchar *block;
       gchar *vendor_model;
-      GString *str;
-      gchar *block;
-      GList *j;
 
       drive = udisks_object_peek_drive (object);
       if (drive == NULL)
         continue;
 
-      str = g_string_new (NULL);
-      blocks = find_blocks_for_drive (objects, g_dbus_object_get_object_path (G_DBUS_OBJECT (object)));
-      for (j = blocks; j != NULL; j = j->next)
-        {
-          UDisksBlock *block_iface = UDISKS_BLOCK (j->data);
-          GDBusObject *block_object;
-          UDisksPartition *partition;
-          block_object = g_dbus_interface_get_object (G_DBUS_INTERFACE (block_iface));
-          partition = block_object == NULL ? NULL : udisks_object_peek_partition (UDISKS_OBJECT (block_object));
-          if (partition == NULL)
-            {
-              const gchar *device_file;
-              if (str->len > 0)
-                g_string_append (str, " ");
-              device_file = udisks_block_get_device (block_iface);
-              if (g_str_has_prefix (device_file, "/dev/"))
-                g_string_append (str, device_file + 5);
-              else
-                g_string_append (str, device_file);
-            }
-        }
-      if (str->len == 0)
-        g_string_append (str, "-");
-      block = g_string_free (str, FALSE);
-      g_list_free_full (blocks, g_object_unref);
+      block = g_hash_table_lookup (drive_blocks, g_dbus_object_get_object_path (G_DBUS_OBJECT (object)));
+      if (block == NULL)
+        block = "-";
 
       vendor = udisks_drive_get_vendor (drive);
       model = udisks_drive_get_model (drive);
@@ -3155,16 +3824,22 @@ handle_command_status (gint        *argc,
         vendor_model = g_strdup ("-");
 
       /* TODO: would be nice to show the port/slot if disk is in a SES-2 enclosure */
-      g_print ("%-25s %-9s %-20s %-8s\n",
-               vendor_model,
-               revision,
-               serial,
-               block);
-      g_free (block);
+      if (opt_status_terse)
+        g_print ("%s\t%s\t%s\t%s\n",
+                 vendor_model,
+                 revision,
+                 serial,
+                 block);
+      else
+        g_print ("%-25s %-9s %-20s %-8s\n",
+                 vendor_model,
+                 revision,
+                 serial,
+                 block);
       g_free (vendor_model);
     }
 
-
+  g_hash_table_unref (drive_blocks);
   g_list_free_full (objects, g_object_unref);
 
   ret = 0;
@@ -3176,6 +3851,271 @@ handle_command_status (gint        *argc,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+static gchar   *opt_batch_file = NULL;
+static gboolean opt_batch_keep_going = FALSE;
+static gboolean opt_batch_quiet = FALSE;
+
+static const GOptionEntry command_batch_entries[] =
+{
+  { "file", 'f', 0, G_OPTION_ARG_FILENAME, &opt_batch_file, "Read commands from FILE instead of stdin", "FILE"},
+  { "keep-going", 'k', 0, G_OPTION_ARG_NONE, &opt_batch_keep_going, "Continue after a command failed", NULL},
+  { "quiet", 'q', 0, G_OPTION_ARG_NONE, &opt_batch_quiet, "Only report commands that failed", NULL},
+  { NULL }
+};
+
+/* The command handlers parse into the static opt_ variables and not all
+ * of them reset every option before parsing, so do it here before each
+ * command of a batch.
+ */
+static void
+reset_command_options (void)
+{
+  opt_mount_unmount_object_path = NULL;
+  opt_mount_unmount_device = NULL;
+  opt_mount_options = NULL;
+  opt_mount_filesystem_type = NULL;
+  opt_unmount_force = FALSE;
+  opt_mount_unmount_no_user_interaction = FALSE;
+
+  opt_unlock_lock_object_path = NULL;
+  opt_unlock_lock_device = NULL;
+  opt_unlock_lock_no_user_interaction = FALSE;
+  g_clear_pointer (&opt_unlock_keyfile, g_free);
+  opt_unlock_read_only = FALSE;
+
+  opt_loop_file = NULL;
+  opt_loop_object_path = NULL;
+  opt_loop_device = NULL;
+  opt_loop_no_user_interaction = FALSE;
+  opt_loop_read_only = FALSE;
+  opt_loop_offset = 0;
+  opt_loop_size = 0;
+  opt_loop_no_partition_scan = FALSE;
+
+  opt_smart_simulate_file = NULL;
+  opt_smart_simulate_object_path = NULL;
+  opt_smart_simulate_device = NULL;
+  opt_smart_simulate_no_user_interaction = FALSE;
+
+  opt_power_off_object_path = NULL;
+  opt_power_off_device = NULL;
+  opt_power_off_no_user_interaction = FALSE;
+
+  opt_info_object = NULL;
+  opt_info_device = NULL;
+  opt_info_drive = NULL;
+
+  opt_dump_objects = NULL;
+  opt_dump_interfaces = NULL;
+  opt_dump_properties = NULL;
+  opt_dump_terse = FALSE;
+
+  opt_status_terse = FALSE;
+}
+
+/* Runs a single command of a batch, @argv is (program, command, args...) */
+static gint
+batch_run_command (gint    *argc,
+                   gchar  **argv[])
+{
+  const gchar *command;
+  gint ret;
+
+  ret = 1;
+  command = (*argv)[1];
+
+  reset_command_options ();
+
+  /* pick up changes caused by the previous command, e.g. the cleartext
+   * device of an unlocked device or a newly set up loop device
+   */
+  udisks_client_settle (client);
+
+  if (g_strcmp0 (command, "info") == 0)
+    ret = handle_command_info (argc, argv, FALSE, NULL, NULL);
+  else if (g_strcmp0 (command, "mount") == 0 || g_strcmp0 (command, "unmount") == 0)
+    ret = handle_command_mount_unmount (argc, argv, FALSE, NULL, NULL, g_strcmp0 (command, "mount") == 0);
+  else if (g_strcmp0 (command, "unlock") == 0 || g_strcmp0 (command, "lock") == 0)
+    ret = handle_command_unlock_lock (argc, argv, FALSE, NULL, NULL, g_strcmp0 (command, "unlock") == 0);
+  else if (g_strcmp0 (command, "loop-setup") == 0 || g_strcmp0 (command, "loop-delete") == 0)
+    ret = handle_command_loop (argc, argv, FALSE, NULL, NULL, g_strcmp0 (command, "loop-setup") == 0);
+  else if (g_strcmp0 (command, "smart-simulate") == 0)
+    ret = handle_command_smart_simulate (argc, argv, FALSE, NULL, NULL);
+  else if (g_strcmp0 (command, "power-off") == 0)
+    ret = handle_command_power_off (argc, argv, FALSE, NULL, NULL);
+  else if (g_strcmp0 (command, "dump") == 0)
+    ret = handle_command_dump (argc, argv, FALSE, NULL, NULL);
+  else if (g_strcmp0 (command, "status") == 0)
+    ret = handle_command_status (argc, argv, FALSE, NULL, NULL);
+  else
+    g_printerr ("Command `%s' is not supported in batch mode\n", command);
+
+  return ret;
+}
+
+static gint
+handle_command_batch (gint        *argc,
+                      gchar      **argv[],
+                      gboolean     request_completion,
+                      const gchar *completion_cur,
+                      const gchar *completion_prev)
+{
+  gint ret;
+  GOptionContext *o;
+  gchar *s;
+  gchar *program_name;
+  const gchar *source_name;
+  FILE *f;
+  gchar *line;
+  size_t line_size;
+  guint line_number;
+  guint num_run;
+  guint num_failed;
+
+  ret = 1;
+  opt_batch_file = NULL;
+  opt_batch_keep_going = FALSE;
+  opt_batch_quiet = FALSE;
+  program_name = NULL;
+  f = NULL;
+  line = NULL;
+  line_size = 0;
+  line_number = 0;
+  num_run = 0;
+  num_failed = 0;
+
+  modify_argv0_for_command (argc, argv, "batch");
+
+  /* the output of all commands and the status lines go to stdout as is */
+  _color_pager_disabled = TRUE;
+
+  o = g_option_context_new (NULL);
+  if (request_completion)
+    g_option_context_set_ignore_unknown_options (o, TRUE);
+  g_option_context_set_help_enabled (o, FALSE);
+  g_option_context_set_summary (o,
+                                "Run commands read from a file or stdin, one per line.\n"
+                                "\n"
+                                "All commands share one connection to the daemon and one\n"
+                                "authentication agent. Empty lines and lines starting with\n"
+                                "`#' are ignored.");
+  g_option_context_add_main_entries (o, command_batch_entries, NULL /* GETTEXT_PACKAGE*/);
+
+  if (!g_option_context_parse (o, argc, argv, NULL))
+    {
+      if (!request_completion)
+        {
+          s = g_option_context_get_help (o, FALSE, NULL);
+          g_printerr ("%s", s);
+          g_free (s);
+          goto out;
+        }
+    }
+
+  if (request_completion)
+    {
+      list_options (command_batch_entries);
+      ret = 0;
+      goto out;
+    }
+
+  if (opt_batch_file != NULL && g_strcmp0 (opt_batch_file, "-") != 0)
+    {
+      f = fopen (opt_batch_file, "r");
+      if (f == NULL)
+        {
+          g_printerr ("Error opening %s: %m\n", opt_batch_file);
+          goto out;
+        }
+      source_name = opt_batch_file;
+    }
+  else
+    {
+      f = stdin;
+      source_name = "<stdin>";
+    }
+
+  /* argv[0] is "udisksctl batch" at this point */
+  program_name = g_strndup ((*argv)[0], strlen ((*argv)[0]) - strlen (" batch"));
+
+  while (getline (&line, &line_size, f) != -1)
+    {
+      gchar **line_argv;
+      gint line_argc;
+      gchar **command_argv;
+      gint command_argc;
+      GError *error;
+      gint command_ret;
+      gint n;
+
+      line_number++;
+      g_strstrip (line);
+      if (line[0] == '\0' || line[0] == '#')
+        continue;
+
+      num_run++;
+
+      error = NULL;
+      if (!g_shell_parse_argv (line, &line_argc, &line_argv, &error))
+        {
+          g_printerr ("%s:%u: Error parsing command: %s\n", source_name, line_number, error->message);
+          g_clear_error (&error);
+          num_failed++;
+          if (!opt_batch_keep_going)
+            break;
+          continue;
+        }
+
+      /* The handlers rewrite and reorder the argument vector so hand them
+       * a shallow copy and keep @line_argv for freeing.
+       */
+      command_argc = line_argc + 1;
+      command_argv = g_new0 (gchar *, command_argc + 1);
+      command_argv[0] = program_name;
+      for (n = 0; n < line_argc; n++)
+        command_argv[n + 1] = line_argv[n];
+
+      command_ret = batch_run_command (&command_argc, &command_argv);
+      if (command_argv[0] != program_name)
+        g_free (command_argv[0]);
+      g_free (command_argv);
+
+      if (command_ret != 0)
+        {
+          num_failed++;
+          g_print ("%s:%u: %s: failed\n", source_name, line_number, line_argv[0]);
+        }
+      else if (!opt_batch_quiet)
+        {
+          g_print ("%s:%u: %s: ok\n", source_name, line_number, line_argv[0]);
+        }
+      g_strfreev (line_argv);
+
+      if (command_ret != 0 && !opt_batch_keep_going)
+        break;
+    }
+
+  if (num_failed > 0)
+    {
+      g_printerr ("%u of %u command(s) failed\n", num_failed, num_run);
+      goto out;
+    }
+
+  ret = 0;
+
+ out:
+  if (f != NULL && f != stdin)
+    fclose (f);
+  free (line);
+  g_free (program_name);
+  g_option_context_free (o);
+  g_free (opt_batch_file);
+  reset_command_options ();
+  return ret;
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
 static void
 usage (gint *argc, gchar **argv[], gboolean use_stdout)
 {
@@ -3206,6 +4146,7 @@ usage (gint *argc, gchar **argv[], gboolean use_stdout)
                        "  loop-delete     Delete a loop device\n"
                        "  power-off       Safely power off a drive\n"
                        "  smart-simulate  Set SMART data for a drive\n"
+                       "  batch           Run several commands over one connection\n"
                        "\n"
                        "Use \"%s COMMAND --help\" to get help on each command.\n",
                        program_name);
@@ -3311,7 +4252,6 @@ main (int argc,
   gboolean request_completion;
   gchar *completion_cur;
   gchar *completion_prev;
-  GError *error;
 
   ret = 1;
   completion_cur = NULL;
@@ -3330,15 +4270,9 @@ main (int argc,
 
   loop = g_main_loop_new (NULL, FALSE);
 
-  error = NULL;
-  client = udisks_client_new_sync (NULL, /* GCancellable */
-                                   &error);
-  if (client == NULL)
-    {
-      g_printerr ("Error connecting to the udisks daemon: %s\n", error->message);
-      g_clear_error (&error);
-      goto out;
-    }
+  /* monitor connects on its own, it may not need the client at all */
+  if (g_strcmp0 (argv[1], "monitor") != 0 && !connect_client ())
+    goto out;
 
   request_completion = FALSE;
 
@@ -3444,6 +4378,15 @@ main (int argc,
                                    completion_prev);
       goto out;
     }
+  else if (g_strcmp0 (command, "batch") == 0)
+    {
+      ret = handle_command_batch (&argc,
+                                  &argv,
+                                  request_completion,
+                                  completion_cur,
+                                  completion_prev);
+      goto out;
+    }
   else if (g_strcmp0 (command, "complete") == 0 && argc == 4 && !request_completion)
     {
       const gchar *completion_line;
@@ -3524,6 +4467,7 @@ main (int argc,
                    "loop-delete \n"
                    "power-off \n"
                    "smart-simulate \n"
+                   "batch \n"
                    );
           ret = 0;
           goto out;
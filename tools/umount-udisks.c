@@ -31,54 +31,21 @@
 
 #include <udisks/udisks.h>
 
-static UDisksObject *
-lookup_object_for_block (UDisksClient  *client,
-                         dev_t          block_device)
-{
-  UDisksObject *ret;
-  GList *objects;
-  GList *l;
-
-  ret = NULL;
-
-  objects = g_dbus_object_manager_get_objects (udisks_client_get_object_manager (client));
-  for (l = objects; l != NULL; l = l->next)
-    {
-      UDisksObject *object = UDISKS_OBJECT (l->data);
-      UDisksBlock *block;
-
-      block = udisks_object_peek_block (object);
-      if (block != NULL)
-        {
-          if (block_device == udisks_block_get_device_number (block))
-            {
-              ret = g_object_ref (object);
-              goto out;
-            }
-        }
-    }
-
- out:
-  g_list_free_full (objects, g_object_unref);
-
-  return ret;
-}
-
 int
 main (int argc, char *argv[])
 {
   gint ret;
   dev_t block_device;
-  UDisksClient *client;
   GError *error;
   struct stat statbuf;
-  UDisksObject *object;
+  gchar *object_path;
   UDisksFilesystem *filesystem;
+  gchar **property_names;
   GVariantBuilder builder;
 
   ret = 1;
-  client = NULL;
-  object = NULL;
+  object_path = NULL;
+  filesystem = NULL;
 
   if (argc < 2 || strlen (argv[1]) == 0)
     {
@@ -97,29 +64,46 @@ main (int argc, char *argv[])
   else
     block_device = statbuf.st_dev;
 
+  /* Only resolve the one object we need instead of creating a
+   * UDisksClient - that would fetch and create proxies for every
+   * object the daemon exports which is expensive with many devices.
+   */
   error = NULL;
-  client = udisks_client_new_sync (NULL, /* GCancellable */
-                                   &error);
-  if (client == NULL)
+  object_path = udisks_client_resolve_block_for_dev_sync (NULL, /* GDBusConnection */
+                                                          block_device,
+                                                          NULL, /* GCancellable */
+                                                          &error);
+  if (object_path == NULL)
     {
-      g_printerr ("Error connecting to the udisks daemon: %s\n", error->message);
+      g_printerr ("Error finding object for block device %u:%u: %s\n",
+                  major (block_device), minor (block_device), error->message);
       g_clear_error (&error);
       goto out;
     }
 
-  object = lookup_object_for_block (client, block_device);
-  if (object == NULL)
+  error = NULL;
+  filesystem = udisks_filesystem_proxy_new_for_bus_sync (G_BUS_TYPE_SYSTEM,
+                                                         G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
+                                                         "org.freedesktop.UDisks2",
+                                                         object_path,
+                                                         NULL, /* GCancellable */
+                                                         &error);
+  if (filesystem == NULL)
     {
-      g_printerr ("Error finding object for block device %u:%u\n", major (block_device), minor (block_device));
+      g_printerr ("Error connecting to the udisks daemon: %s\n", error->message);
+      g_clear_error (&error);
       goto out;
     }
 
-  filesystem = udisks_object_peek_filesystem (object);
-  if (filesystem == NULL)
+  /* the proxy has no cached properties if the object doesn't implement the interface */
+  property_names = g_dbus_proxy_get_cached_property_names (G_DBUS_PROXY (filesystem));
+  if (property_names == NULL || property_names[0] == NULL)
     {
+      g_strfreev (property_names);
       g_printerr ("Block device %u:%u is not a mountable filesystem.\n", major (block_device), minor (block_device));
       goto out;
     }
+  g_strfreev (property_names);
 
   error = NULL;
   g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
@@ -136,9 +120,8 @@ main (int argc, char *argv[])
   ret = 0;
 
  out:
-  if (object != NULL)
-    g_object_unref (object);
-  if (client != NULL)
-    g_object_unref (client);
+  if (filesystem != NULL)
+    g_object_unref (filesystem);
+  g_free (object_path);
   return ret;
 }
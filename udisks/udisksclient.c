@@ -21,6 +21,8 @@
 #include "config.h"
 #include <glib.h>
 #include <glib/gi18n-lib.h>
+#include <locale.h>
+#include <sys/sysmacros.h>
 
 #include "udisksclient.h"
 #include "udiskserror.h"
@@ -57,6 +59,10 @@ struct _UDisksClient
   GMainContext *context;
 
   GSource *changed_timeout_source;
+  guint changed_window_msec;
+  gint64 changed_last_emitted;
+  /* object path -> set of interface names changed since the last emission */
+  GHashTable *changed_objects;
 };
 
 typedef struct
@@ -76,9 +82,18 @@ enum
 enum
 {
   CHANGED_SIGNAL,
+  OBJECTS_CHANGED_SIGNAL,
   LAST_SIGNAL
 };
 
+/* Bounds of the window used to coalesce changes into a single
+ * UDisksClient::changed emission. Isolated changes are delivered after
+ * the short window, under sustained churn the window doubles with
+ * every emission up to the long one.
+ */
+#define CHANGED_WINDOW_MIN_MSEC 50
+#define CHANGED_WINDOW_MAX_MSEC 1000
+
 static guint signals[LAST_SIGNAL] = { 0 };
 
 static void initable_iface_init       (GInitableIface      *initable_iface);
@@ -128,6 +143,7 @@ udisks_client_finalize (GObject *object)
 
   if (client->changed_timeout_source != NULL)
     g_source_destroy (client->changed_timeout_source);
+  g_hash_table_unref (client->changed_objects);
 
   if (client->initialization_error != NULL)
     g_clear_error (&(client->initialization_error));
@@ -171,6 +187,10 @@ udisks_client_init (UDisksClient *client)
    */
   udisks_error_domain = UDISKS_ERROR;
   udisks_error_domain; /* shut up -Wunused-but-set-variable */
+
+  client->changed_window_msec = CHANGED_WINDOW_MIN_MSEC;
+  client->changed_objects = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                                   (GDestroyNotify) g_hash_table_unref);
 }
 
 static void
@@ -292,8 +312,12 @@ udisks_client_class_init (UDisksClientClass *klass)
    *
    * This signal is emitted either when an object or interface is
    * added or removed a when property has changed. Additionally,
-   * multiple received signals are coalesced into a single signal that
-   * is rate-limited to fire at most every 100ms.
+   * multiple received signals are coalesced into a single signal. The
+   * coalescing window starts at 50ms for isolated changes and grows up
+   * to one second while changes keep arriving.
+   *
+   * The #UDisksClient::objects-changed signal is emitted right before
+   * this signal with the set of objects and interfaces that changed.
    *
    * Note that calling udisks_client_settle() will cause this signal
    * to fire if any changes are outstanding.
@@ -316,6 +340,33 @@ udisks_client_class_init (UDisksClientClass *klass)
                                           G_TYPE_NONE,
                                           0);
 
+  /**
+   * UDisksClient::objects-changed:
+   * @client: A #UDisksClient.
+   * @changes: A #GVariant of type <literal>a{oas}</literal>.
+   *
+   * Emitted right before #UDisksClient::changed with the objects
+   * that changed since the last emission. For each object path,
+   * @changes contains the names of the interfaces that were added,
+   * removed or had properties changed. When a whole object was added
+   * or removed, all of its interfaces are listed.
+   *
+   * This allows clients to refresh only the affected parts of their
+   * state instead of rebuilding everything. Changes queued with
+   * udisks_client_queue_changed() by the caller are not listed.
+   *
+   * Since: 2.11.0
+   */
+  signals[OBJECTS_CHANGED_SIGNAL] = g_signal_new ("objects-changed",
+                                                  G_OBJECT_CLASS_TYPE (klass),
+                                                  G_SIGNAL_RUN_LAST,
+                                                  0, /* G_STRUCT_OFFSET */
+                                                  NULL, /* accu */
+                                                  NULL, /* accu data */
+                                                  g_cclosure_marshal_generic,
+                                                  G_TYPE_NONE,
+                                                  1,
+                                                  G_TYPE_VARIANT);
 }
 
 /**
@@ -814,6 +865,264 @@ udisks_client_get_block_for_dev (UDisksClient *client,
   return ret;
 }
 
+/**
+ * udisks_client_resolve_block_for_dev_sync:
+ * @connection: (allow-none): A #GDBusConnection or %NULL to use the system message bus.
+ * @block_device_number: (type guint64): A #dev_t to resolve.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Resolves @block_device_number to the object path of the
+ * corresponding block device by asking the udisks daemon directly.
+ *
+ * Unlike udisks_client_get_block_for_dev() this does not require a
+ * #UDisksClient instance and so avoids fetching and creating proxies
+ * for every object and interface exported by the daemon. It is meant
+ * for short-lived programs that only need to call a single method on
+ * a single object - the returned object path can be used with e.g.
+ * udisks_filesystem_proxy_new_sync().
+ *
+ * This is a synchronous call and blocks the calling thread.
+ *
+ * Returns: (transfer full): The object path (free with g_free()) or
+ * %NULL if @error is set.
+ *
+ * Since: 2.11.0
+ */
+gchar *
+udisks_client_resolve_block_for_dev_sync (GDBusConnection  *connection,
+                                          dev_t             block_device_number,
+                                          GCancellable     *cancellable,
+                                          GError          **error)
+{
+  GDBusConnection *bus = NULL;
+  GVariantBuilder devspec;
+  GVariant *result = NULL;
+  GVariantIter *iter = NULL;
+  gchar *object_path = NULL;
+  gchar *ret = NULL;
+
+  g_return_val_if_fail (connection == NULL || G_IS_DBUS_CONNECTION (connection), NULL);
+  g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  if (connection != NULL)
+    bus = g_object_ref (connection);
+  else
+    bus = g_bus_get_sync (G_BUS_TYPE_SYSTEM, cancellable, error);
+  if (bus == NULL)
+    goto out;
+
+  g_variant_builder_init (&devspec, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add (&devspec, "{sv}", "devnum", g_variant_new_uint64 (block_device_number));
+  result = g_dbus_connection_call_sync (bus,
+                                        "org.freedesktop.UDisks2",
+                                        "/org/freedesktop/UDisks2/Manager",
+                                        "org.freedesktop.UDisks2.Manager",
+                                        "ResolveDevice",
+                                        g_variant_new ("(a{sv}a{sv})", &devspec, NULL),
+                                        G_VARIANT_TYPE ("(ao)"),
+                                        G_DBUS_CALL_FLAGS_NONE,
+                                        -1, /* timeout_msec */
+                                        cancellable,
+                                        error);
+  if (result == NULL)
+    goto out;
+
+  g_variant_get (result, "(ao)", &iter);
+  if (!g_variant_iter_next (iter, "o", &object_path))
+    {
+      g_set_error (error,
+                   UDISKS_ERROR,
+                   UDISKS_ERROR_FAILED,
+                   "No block device with device number %u:%u",
+                   major (block_device_number), minor (block_device_number));
+      goto out;
+    }
+  ret = object_path;
+
+ out:
+  if (iter != NULL)
+    g_variant_iter_free (iter);
+  if (result != NULL)
+    g_variant_unref (result);
+  if (bus != NULL)
+    g_object_unref (bus);
+  return ret;
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+/**
+ * udisks_client_get_objects_sync:
+ * @connection: (allow-none): A #GDBusConnection or %NULL to use the system message bus.
+ * @interfaces: (allow-none) (array zero-terminated=1): Full names of the interfaces to get or %NULL for all interfaces.
+ * @object_path_prefixes: (allow-none) (array zero-terminated=1): Object path prefixes to restrict the result to or %NULL for all objects.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Gets a snapshot of the objects exported by the udisks daemon,
+ * restricted to @interfaces and @object_path_prefixes. The filtering
+ * is done by the daemon so only the requested data is transferred.
+ *
+ * This is meant for small consumers that would otherwise create a
+ * #UDisksClient (and thus a replica of every object, interface and
+ * property) just to look at e.g. the #UDisksDriveAta interfaces. Use
+ * udisks_client_subscribe_properties_changed() to track changes.
+ *
+ * This is a synchronous call and blocks the calling thread.
+ *
+ * Returns: (transfer full): A #GVariant of type <literal>a{oa{sa{sv}}}</literal>
+ * in the same format as returned by GetManagedObjects() or %NULL if
+ * @error is set. Free with g_variant_unref().
+ *
+ * Since: 2.11.0
+ */
+GVariant *
+udisks_client_get_objects_sync (GDBusConnection     *connection,
+                                const gchar *const  *interfaces,
+                                const gchar *const  *object_path_prefixes,
+                                GCancellable        *cancellable,
+                                GError             **error)
+{
+  GDBusConnection *bus = NULL;
+  GVariantBuilder options;
+  GVariant *result = NULL;
+  GVariant *ret = NULL;
+
+  g_return_val_if_fail (connection == NULL || G_IS_DBUS_CONNECTION (connection), NULL);
+  g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  if (connection != NULL)
+    bus = g_object_ref (connection);
+  else
+    bus = g_bus_get_sync (G_BUS_TYPE_SYSTEM, cancellable, error);
+  if (bus == NULL)
+    goto out;
+
+  g_variant_builder_init (&options, G_VARIANT_TYPE_VARDICT);
+  if (interfaces != NULL)
+    g_variant_builder_add (&options, "{sv}", "interfaces", g_variant_new_strv (interfaces, -1));
+  if (object_path_prefixes != NULL)
+    g_variant_builder_add (&options, "{sv}", "object-path-prefixes", g_variant_new_strv (object_path_prefixes, -1));
+
+  result = g_dbus_connection_call_sync (bus,
+                                        "org.freedesktop.UDisks2",
+                                        "/org/freedesktop/UDisks2/Manager",
+                                        "org.freedesktop.UDisks2.Manager",
+                                        "GetObjects",
+                                        g_variant_new ("(a{sv})", &options),
+                                        G_VARIANT_TYPE ("(a{oa{sa{sv}}})"),
+                                        G_DBUS_CALL_FLAGS_NONE,
+                                        -1, /* timeout_msec */
+                                        cancellable,
+                                        error);
+  if (result == NULL)
+    goto out;
+
+  ret = g_variant_get_child_value (result, 0);
+
+ out:
+  if (result != NULL)
+    g_variant_unref (result);
+  if (bus != NULL)
+    g_object_unref (bus);
+  return ret;
+}
+
+typedef struct
+{
+  gchar               *object_path_prefix;
+  GDBusSignalCallback  callback;
+  gpointer             user_data;
+  GDestroyNotify       user_data_free_func;
+} PropertiesChangedData;
+
+static void
+properties_changed_data_free (gpointer user_data)
+{
+  PropertiesChangedData *data = user_data;
+
+  if (data->user_data_free_func != NULL)
+    data->user_data_free_func (data->user_data);
+  g_free (data->object_path_prefix);
+  g_free (data);
+}
+
+static void
+on_properties_changed (GDBusConnection *connection,
+                       const gchar     *sender_name,
+                       const gchar     *object_path,
+                       const gchar     *interface_name,
+                       const gchar     *signal_name,
+                       GVariant        *parameters,
+                       gpointer         user_data)
+{
+  PropertiesChangedData *data = user_data;
+
+  if (data->object_path_prefix != NULL && !g_str_has_prefix (object_path, data->object_path_prefix))
+    return;
+
+  data->callback (connection, sender_name, object_path, interface_name, signal_name, parameters, data->user_data);
+}
+
+/**
+ * udisks_client_subscribe_properties_changed:
+ * @connection: A #GDBusConnection.
+ * @interface_name: Full name of the interface to watch, e.g. <literal>org.freedesktop.UDisks2.Drive.Ata</literal>.
+ * @object_path_prefix: (allow-none): Only report objects whose path starts with this prefix or %NULL.
+ * @callback: Callback to invoke for each org.freedesktop.DBus.Properties.PropertiesChanged signal.
+ * @user_data: User data to pass to @callback.
+ * @user_data_free_func: (allow-none): Function to free @user_data with when the subscription is removed or %NULL.
+ *
+ * Subscribes to property changes of @interface_name on objects
+ * exported by the udisks daemon. Unlike #UDisksClient, which receives
+ * every signal emitted by the daemon, the match rule installed on the
+ * message bus only covers @interface_name so the caller is not woken
+ * up for changes of other interfaces.
+ *
+ * The @callback is invoked in the <link linkend="g-main-context-push-thread-default">thread-default main
+ * loop</link> of the calling thread with the parameters of the
+ * PropertiesChanged signal, i.e. of type <literal>(sa{sv}as)</literal>.
+ *
+ * Returns: A subscription identifier to be used with g_dbus_connection_signal_unsubscribe().
+ *
+ * Since: 2.11.0
+ */
+guint
+udisks_client_subscribe_properties_changed (GDBusConnection     *connection,
+                                            const gchar         *interface_name,
+                                            const gchar         *object_path_prefix,
+                                            GDBusSignalCallback  callback,
+                                            gpointer             user_data,
+                                            GDestroyNotify       user_data_free_func)
+{
+  PropertiesChangedData *data;
+
+  g_return_val_if_fail (G_IS_DBUS_CONNECTION (connection), 0);
+  g_return_val_if_fail (interface_name != NULL, 0);
+  g_return_val_if_fail (callback != NULL, 0);
+
+  data = g_new0 (PropertiesChangedData, 1);
+  data->object_path_prefix = g_strdup (object_path_prefix);
+  data->callback = callback;
+  data->user_data = user_data;
+  data->user_data_free_func = user_data_free_func;
+
+  /* arg0 is the interface name, it ends up in the match rule */
+  return g_dbus_connection_signal_subscribe (connection,
+                                             "org.freedesktop.UDisks2",
+                                             "org.freedesktop.DBus.Properties",
+                                             "PropertiesChanged",
+                                             NULL, /* object_path */
+                                             interface_name,
+                                             G_DBUS_SIGNAL_FLAGS_NONE,
+                                             on_properties_changed,
+                                             data,
+                                             properties_changed_data_free);
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 static int
@@ -1559,6 +1868,41 @@ udisks_client_get_jobs_for_object (UDisksClient  *client,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+static void
+emit_changed (UDisksClient *client)
+{
+  GVariantBuilder builder;
+  GHashTableIter iter;
+  const gchar *object_path;
+  GHashTable *interfaces;
+  GVariant *changes;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{oas}"));
+  g_hash_table_iter_init (&iter, client->changed_objects);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &object_path, (gpointer *) &interfaces))
+    {
+      GHashTableIter iface_iter;
+      const gchar *interface_name;
+
+      g_variant_builder_open (&builder, G_VARIANT_TYPE ("{oas}"));
+      g_variant_builder_add (&builder, "o", object_path);
+      g_variant_builder_open (&builder, G_VARIANT_TYPE_STRING_ARRAY);
+      g_hash_table_iter_init (&iface_iter, interfaces);
+      while (g_hash_table_iter_next (&iface_iter, (gpointer *) &interface_name, NULL))
+        g_variant_builder_add (&builder, "s", interface_name);
+      g_variant_builder_close (&builder);
+      g_variant_builder_close (&builder);
+    }
+  changes = g_variant_ref_sink (g_variant_builder_end (&builder));
+  g_hash_table_remove_all (client->changed_objects);
+
+  client->changed_last_emitted = g_get_monotonic_time ();
+
+  g_signal_emit (client, signals[OBJECTS_CHANGED_SIGNAL], 0, changes);
+  g_signal_emit (client, signals[CHANGED_SIGNAL], 0);
+  g_variant_unref (changes);
+}
+
 static void
 maybe_emit_changed_now (UDisksClient *client)
 {
@@ -1568,7 +1912,7 @@ maybe_emit_changed_now (UDisksClient *client)
   g_source_destroy (client->changed_timeout_source);
   client->changed_timeout_source = NULL;
 
-  g_signal_emit (client, signals[CHANGED_SIGNAL], 0);
+  emit_changed (client);
 
  out:
   ;
@@ -1580,7 +1924,7 @@ on_changed_timeout (gpointer user_data)
 {
   UDisksClient *client = UDISKS_CLIENT (user_data);
   client->changed_timeout_source = NULL;
-  g_signal_emit (client, signals[CHANGED_SIGNAL], 0);
+  emit_changed (client);
   return FALSE; /* remove source */
 }
 
@@ -1597,12 +1941,24 @@ on_changed_timeout (gpointer user_data)
 void
 udisks_client_queue_changed (UDisksClient *client)
 {
+  gint64 now;
+
   g_return_if_fail (UDISKS_IS_CLIENT (client));
 
   if (client->changed_timeout_source != NULL)
     goto out;
 
-  client->changed_timeout_source = g_timeout_source_new (100);
+  /* Grow the window while changes keep coming in right after the
+   * previous emission, go back to the short one once things are quiet.
+   */
+  now = g_get_monotonic_time ();
+  if (client->changed_last_emitted > 0 &&
+      now - client->changed_last_emitted < (gint64) CHANGED_WINDOW_MAX_MSEC * 1000)
+    client->changed_window_msec = MIN (client->changed_window_msec * 2, CHANGED_WINDOW_MAX_MSEC);
+  else
+    client->changed_window_msec = CHANGED_WINDOW_MIN_MSEC;
+
+  client->changed_timeout_source = g_timeout_source_new (client->changed_window_msec);
   g_source_set_callback (client->changed_timeout_source,
                          (GSourceFunc) on_changed_timeout,
                          client,
@@ -1614,6 +1970,42 @@ udisks_client_queue_changed (UDisksClient *client)
   ;
 }
 
+/* Records that @interface_name on @object_path changed and queues a
+ * #UDisksClient::changed signal. All interfaces of the object are
+ * recorded if @interface_name is %NULL.
+ */
+static void
+queue_changed_for_object (UDisksClient *client,
+                          GDBusObject  *object,
+                          const gchar  *interface_name)
+{
+  const gchar *object_path = g_dbus_object_get_object_path (object);
+  GHashTable *interfaces;
+
+  interfaces = g_hash_table_lookup (client->changed_objects, object_path);
+  if (interfaces == NULL)
+    {
+      interfaces = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+      g_hash_table_insert (client->changed_objects, g_strdup (object_path), interfaces);
+    }
+
+  if (interface_name != NULL)
+    {
+      g_hash_table_add (interfaces, g_strdup (interface_name));
+    }
+  else
+    {
+      GList *object_interfaces, *l;
+
+      object_interfaces = g_dbus_object_get_interfaces (object);
+      for (l = object_interfaces; l != NULL; l = l->next)
+        g_hash_table_add (interfaces, g_strdup (g_dbus_proxy_get_interface_name (G_DBUS_PROXY (l->data))));
+      g_list_free_full (object_interfaces, g_object_unref);
+    }
+
+  udisks_client_queue_changed (client);
+}
+
 static void
 on_object_added (GDBusObjectManager  *manager,
                  GDBusObject         *object,
@@ -1629,7 +2021,7 @@ on_object_added (GDBusObjectManager  *manager,
     }
   g_list_free_full (interfaces, g_object_unref);
 
-  udisks_client_queue_changed (client);
+  queue_changed_for_object (client, object, NULL);
 }
 
 static void
@@ -1638,7 +2030,7 @@ on_object_removed (GDBusObjectManager  *manager,
                    gpointer             user_data)
 {
   UDisksClient *client = UDISKS_CLIENT (user_data);
-  udisks_client_queue_changed (client);
+  queue_changed_for_object (client, object, NULL);
 }
 
 static void
@@ -1659,7 +2051,7 @@ on_interface_added (GDBusObjectManager  *manager,
 
   init_interface_proxy (client, G_DBUS_PROXY (interface));
 
-  udisks_client_queue_changed (client);
+  queue_changed_for_object (client, object, g_dbus_proxy_get_interface_name (G_DBUS_PROXY (interface)));
 }
 
 static void
@@ -1669,7 +2061,7 @@ on_interface_removed (GDBusObjectManager  *manager,
                       gpointer             user_data)
 {
   UDisksClient *client = UDISKS_CLIENT (user_data);
-  udisks_client_queue_changed (client);
+  queue_changed_for_object (client, object, g_dbus_proxy_get_interface_name (G_DBUS_PROXY (interface)));
 }
 
 static void
@@ -1696,7 +2088,8 @@ on_interface_proxy_properties_changed (GDBusObjectManagerClient   *manager,
       if (! g_hash_table_contains (client_class->changed_blacklist, property_name))
         {
           /* one of the properties is not on the blacklist -> emit change signal */
-          udisks_client_queue_changed (client);
+          queue_changed_for_object (client, G_DBUS_OBJECT (object_proxy),
+                                    g_dbus_proxy_get_interface_name (interface_proxy));
           return;
         }
     }
@@ -2014,6 +2407,106 @@ udisks_client_get_media_compat_for_display (UDisksClient       *client,
 
 /* ---------------------------------------------------------------------------------------------------- */
 
+/* The display functions below are called for every device on every
+ * refresh of e.g. a file manager, so instead of scanning the static
+ * tables they use hash indexes built on first use. The indexes map a
+ * key made of the looked up fields to the indices of all matching
+ * table entries, in table order.
+ */
+
+static GHashTable *
+table_index_new (void)
+{
+  return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_array_unref);
+}
+
+/* takes ownership of @key */
+static void
+table_index_add (GHashTable *index,
+                 gchar      *key,
+                 guint       n)
+{
+  GArray *entries;
+
+  entries = g_hash_table_lookup (index, key);
+  if (entries == NULL)
+    {
+      entries = g_array_new (FALSE, FALSE, sizeof (guint));
+      g_hash_table_insert (index, key, entries);
+    }
+  else
+    {
+      g_free (key);
+    }
+  g_array_append_val (entries, n);
+}
+
+static GArray *
+table_index_lookup (GHashTable  *index,
+                    const gchar *format,
+                    ...) G_GNUC_PRINTF (2, 3);
+
+static GArray *
+table_index_lookup (GHashTable  *index,
+                    const gchar *format,
+                    ...)
+{
+  gchar key[256];
+  va_list var_args;
+
+  va_start (var_args, format);
+  g_vsnprintf (key, sizeof (key), format, var_args);
+  va_end (var_args);
+
+  return g_hash_table_lookup (index, key);
+}
+
+/* Translations are cached per message context and dropped when the
+ * LC_MESSAGES locale changes.
+ */
+typedef struct
+{
+  const gchar *context;
+  GHashTable  *translations;  /* msgid -> translated string, both not owned */
+  gchar       *locale;
+} TranslationCache;
+
+G_LOCK_DEFINE_STATIC (translation_cache_lock);
+
+static const gchar *
+translate_cached (TranslationCache *cache,
+                  const gchar      *msgid)
+{
+  const gchar *locale;
+  const gchar *ret;
+
+  G_LOCK (translation_cache_lock);
+  locale = setlocale (LC_MESSAGES, NULL);
+  if (cache->translations == NULL)
+    {
+      cache->translations = g_hash_table_new (g_direct_hash, g_direct_equal);
+      cache->locale = g_strdup (locale);
+    }
+  else if (g_strcmp0 (locale, cache->locale) != 0)
+    {
+      g_hash_table_remove_all (cache->translations);
+      g_free (cache->locale);
+      cache->locale = g_strdup (locale);
+    }
+
+  ret = g_hash_table_lookup (cache->translations, msgid);
+  if (ret == NULL)
+    {
+      ret = g_dpgettext2 (GETTEXT_PACKAGE, cache->context, msgid);
+      g_hash_table_insert (cache->translations, (gpointer) msgid, (gpointer) ret);
+    }
+  G_UNLOCK (translation_cache_lock);
+
+  return ret;
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
 static const struct
 {
   const gchar *usage;
@@ -2073,6 +2566,26 @@ static const struct
   {NULL, NULL, NULL, NULL}
 };
 
+static TranslationCache fs_type_translations = { "fs-type", NULL, NULL };
+
+/* "usage\ttype" -> entries of id_type */
+static GHashTable *
+get_id_type_index (void)
+{
+  static GHashTable *index = NULL;
+
+  if (g_once_init_enter (&index))
+    {
+      GHashTable *tmp = table_index_new ();
+      guint n;
+
+      for (n = 0; id_type[n].usage != NULL; n++)
+        table_index_add (tmp, g_strdup_printf ("%s\t%s", id_type[n].usage, id_type[n].type), n);
+      g_once_init_leave (&index, tmp);
+    }
+  return index;
+}
+
 /**
  * udisks_client_get_id_for_display:
  * @client: A #UDisksClient.
@@ -2092,7 +2605,8 @@ udisks_client_get_id_for_display (UDisksClient *client,
                                   const gchar  *version,
                                   gboolean      long_string)
 {
-  guint n;
+  GArray *entries;
+  guint m, n;
   gchar *ret = NULL;
 
   if (usage == NULL || type == NULL || version == NULL)
@@ -2101,40 +2615,38 @@ udisks_client_get_id_for_display (UDisksClient *client,
       goto out;
     }
 
-  for (n = 0; id_type[n].usage != NULL; n++)
+  entries = table_index_lookup (get_id_type_index (), "%s\t%s", usage, type);
+  for (m = 0; entries != NULL && m < entries->len; m++)
     {
-      if (g_strcmp0 (id_type[n].usage, usage) == 0 &&
-          g_strcmp0 (id_type[n].type, type) == 0)
+      n = g_array_index (entries, guint, m);
+      if ((id_type[n].version == NULL && strlen (version) == 0))
         {
-          if ((id_type[n].version == NULL && strlen (version) == 0))
-            {
-              if (long_string)
-                ret = g_strdup (g_dpgettext2 (GETTEXT_PACKAGE, "fs-type", id_type[n].long_name));
-              else
-                ret = g_strdup (g_dpgettext2 (GETTEXT_PACKAGE, "fs-type", id_type[n].short_name));
-              goto out;
-            }
-          else if ((g_strcmp0 (id_type[n].version, version) == 0 && strlen (version) > 0) ||
-                   (g_strcmp0 (id_type[n].version, "*") == 0 && strlen (version) > 0))
-            {
-              /* we know better than the compiler here */
+          if (long_string)
+            ret = g_strdup (translate_cached (&fs_type_translations, id_type[n].long_name));
+          else
+            ret = g_strdup (translate_cached (&fs_type_translations, id_type[n].short_name));
+          goto out;
+        }
+      else if ((g_strcmp0 (id_type[n].version, version) == 0 && strlen (version) > 0) ||
+               (g_strcmp0 (id_type[n].version, "*") == 0 && strlen (version) > 0))
+        {
+          /* we know better than the compiler here */
 #if defined(__GNUC__) || defined(__clang__)
 # if G_GNUC_CHECK_VERSION(4, 6) || __clang__
 #  pragma GCC diagnostic push
 #  pragma GCC diagnostic ignored "-Wformat-nonliteral"
 # endif
 #endif
-              if (long_string)
-                ret = g_strdup_printf (g_dpgettext2 (GETTEXT_PACKAGE, "fs-type", id_type[n].long_name), version);
-              else
-                ret = g_strdup_printf (g_dpgettext2 (GETTEXT_PACKAGE, "fs-type", id_type[n].short_name), version);
-              goto out;
+          if (long_string)
+            ret = g_strdup_printf (translate_cached (&fs_type_translations, id_type[n].long_name), version);
+          else
+            ret = g_strdup_printf (translate_cached (&fs_type_translations, id_type[n].short_name), version);
+          goto out;
 #if defined(__GNUC__) || defined(__clang__)
 # if G_GNUC_CHECK_VERSION(4, 6) || __clang__
 #  pragma GCC diagnostic pop
 # endif
 #endif
-            }
         }
     }
 
@@ -2254,6 +2766,8 @@ static const struct
   {NULL, NULL}
 };
 
+static TranslationCache partition_subtype_translations = { "partition-subtype", NULL, NULL };
+
 /**
  * udisks_client_get_partition_table_subtype_for_display:
  * @client: A #UDisksClient.
@@ -2278,7 +2792,7 @@ udisks_client_get_partition_table_subtype_for_display (UDisksClient  *client,
       if (g_strcmp0 (known_partition_table_subtypes[n].type,    partition_table_type) == 0 &&
           g_strcmp0 (known_partition_table_subtypes[n].subtype, partition_table_subtype) == 0)
         {
-          ret = g_dpgettext2 (GETTEXT_PACKAGE, "partition-subtype", known_partition_table_subtypes[n].name);
+          ret = translate_cached (&partition_subtype_translations, known_partition_table_subtypes[n].name);
           goto out;
         }
     }
@@ -2589,6 +3103,44 @@ static const struct
   {NULL,  NULL, NULL}
 };
 
+static TranslationCache part_type_translations = { "part-type", NULL, NULL };
+
+/* Indexes entries of known_partition_types by
+ *
+ *  "t:TABLE_TYPE"
+ *  "ts:TABLE_TYPE\tTABLE_SUBTYPE"
+ *  "tt:TABLE_TYPE\tTYPE"
+ *  "tst:TABLE_TYPE\tTABLE_SUBTYPE\tTYPE"
+ */
+static GHashTable *
+get_partition_type_index (void)
+{
+  static GHashTable *index = NULL;
+
+  if (g_once_init_enter (&index))
+    {
+      GHashTable *tmp = table_index_new ();
+      guint n;
+
+      for (n = 0; known_partition_types[n].name != NULL; n++)
+        {
+          table_index_add (tmp, g_strdup_printf ("t:%s", known_partition_types[n].table_type), n);
+          table_index_add (tmp, g_strdup_printf ("ts:%s\t%s",
+                                                 known_partition_types[n].table_type,
+                                                 known_partition_types[n].table_subtype), n);
+          table_index_add (tmp, g_strdup_printf ("tt:%s\t%s",
+                                                 known_partition_types[n].table_type,
+                                                 known_partition_types[n].type), n);
+          table_index_add (tmp, g_strdup_printf ("tst:%s\t%s\t%s",
+                                                 known_partition_types[n].table_type,
+                                                 known_partition_types[n].table_subtype,
+                                                 known_partition_types[n].type), n);
+        }
+      g_once_init_leave (&index, tmp);
+    }
+  return index;
+}
+
 /**
  * udisks_client_get_partition_type_infos:
  * @client: A #UDisksClient.
@@ -2607,21 +3159,27 @@ udisks_client_get_partition_type_infos (UDisksClient   *client,
                                         const gchar    *partition_table_subtype)
 {
   GList *ret = NULL;
-  guint n;
+  GArray *entries;
+  guint m, n;
+
+  if (partition_table_type == NULL)
+    return NULL;
+
+  if (partition_table_subtype == NULL)
+    entries = table_index_lookup (get_partition_type_index (), "t:%s", partition_table_type);
+  else
+    entries = table_index_lookup (get_partition_type_index (), "ts:%s\t%s",
+                                  partition_table_type, partition_table_subtype);
 
-  for (n = 0; known_partition_types[n].name != NULL; n++)
+  for (m = 0; entries != NULL && m < entries->len; m++)
     {
-      if (g_strcmp0 (known_partition_types[n].table_type, partition_table_type) == 0 &&
-          (partition_table_subtype == NULL ||
-           g_strcmp0 (known_partition_types[n].table_subtype, partition_table_subtype) == 0))
-        {
-          UDisksPartitionTypeInfo *info = udisks_partition_type_info_new ();
-          info->table_type    = known_partition_types[n].table_type;
-          info->table_subtype = known_partition_types[n].table_subtype;
-          info->type          = known_partition_types[n].type;
-          info->flags         = known_partition_types[n].flags;
-          ret = g_list_prepend (ret, info);
-        }
+      UDisksPartitionTypeInfo *info = udisks_partition_type_info_new ();
+      n = g_array_index (entries, guint, m);
+      info->table_type    = known_partition_types[n].table_type;
+      info->table_subtype = known_partition_types[n].table_subtype;
+      info->type          = known_partition_types[n].type;
+      info->flags         = known_partition_types[n].flags;
+      ret = g_list_prepend (ret, info);
     }
   ret = g_list_reverse (ret);
   return ret;
@@ -2644,17 +3202,14 @@ udisks_client_get_partition_type_for_display (UDisksClient  *client,
                                               const gchar   *partition_type)
 {
   const gchar *ret = NULL;
-  guint n;
+  GArray *entries;
 
-  for (n = 0; known_partition_types[n].name != NULL; n++)
-    {
-      if (g_strcmp0 (known_partition_types[n].table_type, partition_table_type) == 0 &&
-          g_strcmp0 (known_partition_types[n].type, partition_type) == 0)
-        {
-          ret = g_dpgettext2 (GETTEXT_PACKAGE, "part-type", known_partition_types[n].name);
-          goto out;
-        }
-    }
+  if (partition_table_type == NULL || partition_type == NULL)
+    goto out;
+
+  entries = table_index_lookup (get_partition_type_index (), "tt:%s\t%s", partition_table_type, partition_type);
+  if (entries != NULL)
+    ret = translate_cached (&part_type_translations, known_partition_types[g_array_index (entries, guint, 0)].name);
 
  out:
   return ret;
@@ -2684,20 +3239,19 @@ udisks_client_get_partition_type_and_subtype_for_display (UDisksClient  *client,
                                                           const gchar   *partition_type)
 {
   const gchar *ret = NULL;
-  guint n;
+  GArray *entries;
 
-  for (n = 0; known_partition_types[n].name != NULL; n++)
-    {
-      if (g_strcmp0 (known_partition_types[n].table_type, partition_table_type) == 0 &&
-          g_strcmp0 (known_partition_types[n].type, partition_type) == 0)
-        {
-          if (partition_table_subtype != NULL &&
-              g_strcmp0 (known_partition_types[n].table_subtype, partition_table_subtype) != 0)
-            continue;
-          ret = g_dpgettext2 (GETTEXT_PACKAGE, "part-type", known_partition_types[n].name);
-          goto out;
-        }
-    }
+  if (partition_table_type == NULL || partition_type == NULL)
+    goto out;
+
+  if (partition_table_subtype == NULL)
+    entries = table_index_lookup (get_partition_type_index (), "tt:%s\t%s",
+                                  partition_table_type, partition_type);
+  else
+    entries = table_index_lookup (get_partition_type_index (), "tst:%s\t%s\t%s",
+                                  partition_table_type, partition_table_subtype, partition_type);
+  if (entries != NULL)
+    ret = translate_cached (&part_type_translations, known_partition_types[g_array_index (entries, guint, 0)].name);
 
  out:
   return ret;
@@ -2736,6 +3290,7 @@ udisks_client_get_job_description_from_operation (const gchar *operation)
       g_hash_table_insert (hash, (gpointer) "encrypted-resize",     (gpointer) C_("job", "Resizing Encrypted Device"));
       g_hash_table_insert (hash, (gpointer) "encrypted-convert",    (gpointer) C_("job", "Converting Encrypted Device"));
       g_hash_table_insert (hash, (gpointer) "encrypted-header-backup",    (gpointer) C_("job", "Backing Up Header of an Encrypted Device"));
+      g_hash_table_insert (hash, (gpointer) "block-benchmark",      (gpointer) C_("job", "Benchmarking Device"));
       g_hash_table_insert (hash, (gpointer) "block-restore-encrypted-header",    (gpointer) C_("job", "Restoring Header of an Encrypted Device"));
       g_hash_table_insert (hash, (gpointer) "swapspace-start",      (gpointer) C_("job", "Starting Swap Device"));
       g_hash_table_insert (hash, (gpointer) "swapspace-stop",       (gpointer) C_("job", "Stopping Swap Device"));
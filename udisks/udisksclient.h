@@ -61,6 +61,22 @@ UDisksObject       *udisks_client_peek_object         (UDisksClient        *clie
 
 UDisksBlock        *udisks_client_get_block_for_dev   (UDisksClient        *client,
                                                        dev_t                block_device_number);
+gchar              *udisks_client_resolve_block_for_dev_sync (GDBusConnection  *connection,
+                                                              dev_t             block_device_number,
+                                                              GCancellable     *cancellable,
+                                                              GError          **error);
+
+GVariant           *udisks_client_get_objects_sync (GDBusConnection     *connection,
+                                                    const gchar *const  *interfaces,
+                                                    const gchar *const  *object_path_prefixes,
+                                                    GCancellable        *cancellable,
+                                                    GError             **error);
+guint               udisks_client_subscribe_properties_changed (GDBusConnection     *connection,
+                                                                const gchar         *interface_name,
+                                                                const gchar         *object_path_prefix,
+                                                                GDBusSignalCallback  callback,
+                                                                gpointer             user_data,
+                                                                GDestroyNotify       user_data_free_func);
 GList              *udisks_client_get_block_for_label (UDisksClient        *client,
                                                        const gchar         *label);
 GList              *udisks_client_get_block_for_uuid  (UDisksClient        *client,
@@ -76,6 +76,9 @@ struct _UDisksObjectInfo
   GIcon *media_icon_symbolic;
   gchar *one_liner;
   gchar *sort_key;
+
+  /* object paths of other objects the information was derived from */
+  GPtrArray *deps;
 };
 
 typedef struct _UDisksObjectInfoClass UDisksObjectInfoClass;
@@ -104,6 +107,7 @@ udisks_object_info_finalize (GObject *object)
   g_clear_object (&info->media_icon_symbolic);
   g_free (info->one_liner);
   g_free (info->sort_key);
+  g_ptr_array_unref (info->deps);
 
   G_OBJECT_CLASS (udisks_object_info_parent_class)->finalize (object);
 }
@@ -111,6 +115,7 @@ udisks_object_info_finalize (GObject *object)
 static void
 udisks_object_info_init (UDisksObjectInfo *info)
 {
+  info->deps = g_ptr_array_new_with_free_func (g_free);
 }
 
 static void
@@ -135,6 +140,175 @@ udisks_object_info_new (UDisksObject *object)
   return ret;
 }
 
+/* Records that @info was derived from the object @iface belongs to */
+static void
+udisks_object_info_add_dep (UDisksObjectInfo *info,
+                            gpointer          iface)
+{
+  GDBusObject *object;
+
+  if (iface == NULL)
+    return;
+
+  object = g_dbus_interface_get_object (G_DBUS_INTERFACE (iface));
+  if (object != NULL)
+    g_ptr_array_add (info->deps, g_strdup (g_dbus_object_get_object_path (object)));
+}
+
+/* ---------------------------------------------------------------------------------------------------- */
+
+/* Per-client cache of UDisksObjectInfo instances.
+ *
+ * An entry is dropped when its object, or any object it was derived
+ * from (e.g. the drive of a block device or the block device of a
+ * drive), is added, removed or has a property changed.
+ */
+typedef struct
+{
+  GDBusObjectManager *object_manager;
+  GHashTable *infos;       /* object path -> UDisksObjectInfo */
+  GHashTable *dependents;  /* object path -> set of object paths whose info was derived from it */
+} ObjectInfoCache;
+
+static GQuark
+object_info_cache_quark (void)
+{
+  static GQuark quark = 0;
+  if (G_UNLIKELY (quark == 0))
+    quark = g_quark_from_static_string ("udisks-object-info-cache");
+  return quark;
+}
+
+static void
+object_info_cache_invalidate_path (ObjectInfoCache *cache,
+                                   const gchar     *object_path)
+{
+  GHashTable *dependents;
+  GHashTableIter iter;
+  const gchar *dependent;
+
+  if (object_path == NULL || g_strcmp0 (object_path, "/") == 0)
+    return;
+
+  g_hash_table_remove (cache->infos, object_path);
+
+  dependents = g_hash_table_lookup (cache->dependents, object_path);
+  if (dependents == NULL)
+    return;
+  g_hash_table_iter_init (&iter, dependents);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &dependent, NULL))
+    g_hash_table_remove (cache->infos, dependent);
+  g_hash_table_remove (cache->dependents, object_path);
+}
+
+static void
+object_info_cache_invalidate (ObjectInfoCache *cache,
+                              GDBusObject     *object)
+{
+  UDisksBlock *block;
+
+  object_info_cache_invalidate_path (cache, g_dbus_object_get_object_path (object));
+
+  /* a block device appearing or going away may change the information for its drive or array */
+  block = udisks_object_peek_block (UDISKS_OBJECT (object));
+  if (block != NULL)
+    {
+      object_info_cache_invalidate_path (cache, udisks_block_get_drive (block));
+      object_info_cache_invalidate_path (cache, udisks_block_get_mdraid (block));
+    }
+}
+
+static void
+on_cache_object_changed (GDBusObjectManager *manager,
+                         GDBusObject        *object,
+                         gpointer            user_data)
+{
+  object_info_cache_invalidate (user_data, object);
+}
+
+static void
+on_cache_interface_changed (GDBusObjectManager *manager,
+                            GDBusObject        *object,
+                            GDBusInterface     *interface,
+                            gpointer            user_data)
+{
+  object_info_cache_invalidate (user_data, object);
+}
+
+static void
+on_cache_properties_changed (GDBusObjectManagerClient *manager,
+                             GDBusObjectProxy         *object_proxy,
+                             GDBusProxy               *interface_proxy,
+                             GVariant                 *changed_properties,
+                             const gchar *const       *invalidated_properties,
+                             gpointer                  user_data)
+{
+  object_info_cache_invalidate (user_data, G_DBUS_OBJECT (object_proxy));
+}
+
+static void
+object_info_cache_free (ObjectInfoCache *cache)
+{
+  g_signal_handlers_disconnect_by_data (cache->object_manager, cache);
+  g_object_unref (cache->object_manager);
+  g_hash_table_unref (cache->infos);
+  g_hash_table_unref (cache->dependents);
+  g_free (cache);
+}
+
+static ObjectInfoCache *
+object_info_cache_get (UDisksClient *client)
+{
+  ObjectInfoCache *cache;
+
+  cache = g_object_get_qdata (G_OBJECT (client), object_info_cache_quark ());
+  if (cache != NULL)
+    return cache;
+
+  cache = g_new0 (ObjectInfoCache, 1);
+  cache->object_manager = g_object_ref (udisks_client_get_object_manager (client));
+  cache->infos = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+  cache->dependents = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_hash_table_unref);
+
+  g_signal_connect (cache->object_manager, "object-added", G_CALLBACK (on_cache_object_changed), cache);
+  g_signal_connect (cache->object_manager, "object-removed", G_CALLBACK (on_cache_object_changed), cache);
+  g_signal_connect (cache->object_manager, "interface-added", G_CALLBACK (on_cache_interface_changed), cache);
+  g_signal_connect (cache->object_manager, "interface-removed", G_CALLBACK (on_cache_interface_changed), cache);
+  g_signal_connect (cache->object_manager, "interface-proxy-properties-changed",
+                    G_CALLBACK (on_cache_properties_changed), cache);
+
+  g_object_set_qdata_full (G_OBJECT (client), object_info_cache_quark (), cache,
+                           (GDestroyNotify) object_info_cache_free);
+  return cache;
+}
+
+static void
+object_info_cache_insert (ObjectInfoCache  *cache,
+                          UDisksObjectInfo *info)
+{
+  const gchar *object_path = g_dbus_object_get_object_path (G_DBUS_OBJECT (info->object));
+  guint n;
+
+  g_hash_table_insert (cache->infos, g_strdup (object_path), g_object_ref (info));
+
+  for (n = 0; n < info->deps->len; n++)
+    {
+      const gchar *dep = info->deps->pdata[n];
+      GHashTable *dependents;
+
+      if (g_strcmp0 (dep, object_path) == 0)
+        continue;
+
+      dependents = g_hash_table_lookup (cache->dependents, dep);
+      if (dependents == NULL)
+        {
+          dependents = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+          g_hash_table_insert (cache->dependents, g_strdup (dep), dependents);
+        }
+      g_hash_table_add (dependents, g_strdup (object_path));
+    }
+}
+
 /* ---------------------------------------------------------------------------------------------------- */
 
 typedef enum
@@ -380,6 +554,7 @@ udisks_client_get_object_info_for_mdraid (UDisksClient     *client,
   gchar *s;
 
   block = udisks_client_get_block_for_mdraid (client, mdraid);
+  udisks_object_info_add_dep (info, block);
 
   size = udisks_mdraid_get_size (mdraid);
   if (size > 0)
@@ -787,6 +962,7 @@ udisks_client_get_object_info_for_drive (UDisksClient     *client,
 
   /* Apply UDISKS_NAME, UDISKS_ICON_NAME, UDISKS_SYMBOLIC_ICON_NAME hints, if available */
   block = udisks_client_get_block_for_drive (client, drive, TRUE);
+  udisks_object_info_add_dep (info, block);
   if (block != NULL)
     {
       cs = udisks_block_get_hint_name (block);
@@ -888,6 +1064,11 @@ udisks_client_get_object_info_for_drive (UDisksClient     *client,
  * present in an user interface. Information is returned in the
  * #UDisksObjectInfo object and is localized.
  *
+ * The information is cached by @client and only recomputed when
+ * @object or one of the objects it is derived from changes, so it is
+ * cheap to call this repeatedly e.g. on every #UDisksClient::changed
+ * signal.
+ *
  * Returns: (transfer full): A #UDisksObjectInfo instance that should be freed with g_object_unref().
  *
  * Since: 2.1
@@ -902,16 +1083,29 @@ udisks_client_get_object_info (UDisksClient        *client,
   UDisksPartition *partition = NULL;
   UDisksMDRaid *mdraid = NULL;
   UDisksLoop *loop = NULL;
+  ObjectInfoCache *cache;
 
   g_return_val_if_fail (UDISKS_IS_CLIENT (client), NULL);
   g_return_val_if_fail (UDISKS_IS_OBJECT (object), NULL);
 
+  cache = object_info_cache_get (client);
+  ret = g_hash_table_lookup (cache->infos, g_dbus_object_get_object_path (G_DBUS_OBJECT (object)));
+  if (ret != NULL && ret->object == object)
+    return g_object_ref (ret);
+
   ret = udisks_object_info_new (object);
   drive = udisks_object_get_drive (object);
   block = udisks_object_get_block (object);
   loop = udisks_object_get_loop (object);
   partition = udisks_object_get_partition (object);
   mdraid = udisks_object_get_mdraid (object);
+  if (partition != NULL)
+    {
+      /* partition flags and type descriptions are read from the table */
+      UDisksPartitionTable *table = udisks_client_get_partition_table (client, partition);
+      udisks_object_info_add_dep (ret, table);
+      g_clear_object (&table);
+    }
   if (drive != NULL)
     {
       udisks_client_get_object_info_for_drive (client, drive, NULL, ret);
@@ -925,6 +1119,7 @@ udisks_client_get_object_info (UDisksClient        *client,
       drive = udisks_client_get_drive_for_block (client, block);
       if (drive != NULL)
         {
+          udisks_object_info_add_dep (ret, drive);
           udisks_client_get_object_info_for_drive (client, drive, partition, ret);
           goto out;
         }
@@ -932,6 +1127,7 @@ udisks_client_get_object_info (UDisksClient        *client,
       mdraid = udisks_client_get_mdraid_for_block (client, block);
       if (mdraid != NULL)
         {
+          udisks_object_info_add_dep (ret, mdraid);
           udisks_client_get_object_info_for_mdraid (client, mdraid, partition, ret);
           goto out;
         }
@@ -960,6 +1156,8 @@ udisks_client_get_object_info (UDisksClient        *client,
            ret->sort_key);
 #endif
 
+  object_info_cache_insert (cache, ret);
+
   return ret;
 }
 